@@ -4,28 +4,42 @@
 */
 
 #include "AmigaCatalog.h"
-
+#include "CatalogAttributes.h"
+#include "CatalogCache.h"
+#include "CatalogIndex.h"
+#include "CatalogLoader.h"
+#include "CatalogWatcher.h"
+#include "CTLGWriter.h"
+#include "MappedFile.h"
+#include "SharedImage.h"
+
+#include <functional>
 #include <iostream>
 #include <memory>
 #include <new>
+#include <system_error>
+#include <vector>
 
-#include <arpa/inet.h>
+#include <fcntl.h>
 #include <libgen.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include <sys/stat.h>
 
 #include <Application.h>
 #include <Directory.h>
 #include <File.h>
 #include <FindDirectory.h>
 #include <fs_attr.h>
-#include <Language.h>
 #include <Mime.h>
 #include <Path.h>
 #include <Resources.h>
 #include <Roster.h>
-#include <StackOrHeapArray.h>
 #include <String.h>
-#include <UTF8.h>
 
+#include <AutoDeleter.h>
 #include <LocaleRoster.h>
 #include <Catalog.h>
 
@@ -35,6 +49,16 @@ class BMessage;
 
 using BPrivate::HashMapCatalog;
 using BPrivate::AmigaCatalog;
+using BPrivate::CatalogCache;
+using BPrivate::CatalogWatcher;
+using BPrivate::CatKey;
+using BPrivate::CTLGWriter;
+using BPrivate::add_table_strings;
+using BPrivate::IDStringTable;
+using BPrivate::MappedFile;
+using BPrivate::read_mapped_catalog;
+using BPrivate::read_streamed_catalog;
+using BPrivate::SharedImage;
 
 
 /*	This add-on implements reading of Amiga catalog files. These are IFF files
@@ -49,24 +73,149 @@ using BPrivate::AmigaCatalog;
 
 static const char *kCatFolder = "Catalogs/";
 static const char *kCatExtension = ".catalog";
+static const char *kCacheFolder = "AmigaCatalogs";
+	// in the user cache directory
 
-const char *AmigaCatalog::kCatMimeType
-	= "locale/x-vnd.Be.locale-catalog.amiga";
+const char *AmigaCatalog::kCatMimeType = BPrivate::kCatalogMimeType;
 
 static int16 kCatArchiveVersion = 1;
 	// version of the catalog archive structure, bump this if you change it!
 
+static const size_t kParallelDecodeThreshold = 16384;
+	// catalogs with at least that many strings are decoded on several threads
+
+static const size_t kMaxReloadCount = 64;
+	// reloads done at most, as every reloaded catalog is kept until the
+	// catalog is deleted
+
+
+/*
+ * lists the Catalogs/ folders to look for catalogs in, from the highest
+ * priority to the lowest.
+ */
+static std::vector<BString>
+find_catalog_folders()
+{
+	std::vector<BString> folders;
+
+	// give highest priority to catalog living in sub-folder of app's folder:
+	image_info info;
+	int32 cookie = 0;
+	if (get_next_image_info(B_CURRENT_TEAM, &cookie, &info) == B_OK) {
+		BString folder(dirname(info.name));
+		folder << "/" << kCatFolder;
+		folders.push_back(folder);
+	}
+
+	// then the common-etc folder (/boot/home/config/etc), and the
+	// system-etc folder (/boot/beos/etc):
+	static const directory_which kEtcDirectories[] = {
+		B_USER_ETC_DIRECTORY,
+		B_SYSTEM_ETC_DIRECTORY
+	};
+	for (size_t i = 0; i < B_COUNT_OF(kEtcDirectories); i++) {
+		BPath etcPath;
+		if (find_directory(kEtcDirectories[i], &etcPath) != B_OK)
+			continue;
+
+		BString folder(etcPath.Path());
+		folder << "/" << kCatFolder;
+		folders.push_back(folder);
+	}
+
+	return folders;
+}
+
+
+/*
+ * the folders don't change while the application runs, they are only looked
+ * up by the first instantiation.
+ */
+static const std::vector<BString>&
+catalog_folders()
+{
+	static const std::vector<BString> sFolders = find_catalog_folders();
+	return sFolders;
+}
+
+
+enum {
+	kOptionAsync	= 0x01,
+	kOptionReload	= 0x02,
+	kOptionLazy		= 0x04
+};
+
+
+/*
+ * parses the AMIGA_CATALOG_OPTIONS environment variable, a list of words
+ * separated by spaces or commas:
+ * - async: catalogs are loaded on a separate thread, lookups wait for it
+ *   to be done.
+ * - reload: catalog files are watched, and loaded again when they change.
+ * - lazy: strings are only decoded when they are first looked up.
+ */
+static uint32
+parse_catalog_options(const char *options)
+{
+	uint32 flags = 0;
+	if (options == NULL)
+		return flags;
+
+	while (*options != '\0') {
+		size_t length = strcspn(options, " ,");
+		if (length == 5 && strncmp(options, "async", length) == 0)
+			flags |= kOptionAsync;
+		else if (length == 6 && strncmp(options, "reload", length) == 0)
+			flags |= kOptionReload;
+		else if (length == 4 && strncmp(options, "lazy", length) == 0)
+			flags |= kOptionLazy;
+
+		options += length;
+		options += strspn(options, " ,");
+	}
+	return flags;
+}
+
+
+static uint32
+catalog_options()
+{
+	static const uint32 sOptions
+		= parse_catalog_options(getenv("AMIGA_CATALOG_OPTIONS"));
+	return sOptions;
+}
+
+
+static BPrivate::CatalogIndex&
+catalog_index()
+{
+	static BPrivate::CatalogIndex sIndex(kCatExtension);
+	return sIndex;
+}
+
 
 /*
  * constructs a AmigaCatalog with given signature and language and reads
  * the catalog from disk.
  * InitCheck() will be B_OK if catalog could be loaded successfully, it will
  * give an appropriate error-code otherwise.
+ * With the async option, it is B_OK as soon as a catalog file exists, and
+ * the catalog is read on a separate thread. If reading fails, the catalog
+ * stays empty.
  */
 AmigaCatalog::AmigaCatalog(const entry_ref& owner, const char *language,
 	uint32 fingerprint)
 	:
-	HashMapCatalog("", language, fingerprint)
+	HashMapCatalog("", language, fingerprint),
+	fSource(NULL),
+	fSharedImage(NULL),
+	fLoadLazily((catalog_options() & kOptionLazy) != 0),
+	fUseCache(true),
+	fProbeCount(0),
+	fLoaded(true),
+	fLoadedCatalog(NULL),
+	fTable(&fStrings),
+	fWatcher(NULL)
 {
 	// This catalog uses the executable name to identify the catalog
 	// (not the MIME signature)
@@ -77,44 +226,38 @@ AmigaCatalog::AmigaCatalog(const entry_ref& owner, const char *language,
 
 	// This catalog uses the translated language name to identify the catalog
 	// (not the ISO language code)
-	BLanguage lang(language);
-	lang.GetNativeName(fLanguageName);
-
-	// give highest priority to catalog living in sub-folder of app's folder:
-	BString catalogName(kCatFolder);
-	catalogName << fLanguageName
-		<< "/" << fSignature
-		<< kCatExtension;
-
-	image_info info;
-	int32 cookie = 0;
-	status_t r = get_next_image_info(B_CURRENT_TEAM, &cookie, &info);
-	BString dirName(dirname(info.name));
-	dirName << "/" << catalogName;
-
-	status_t status = ReadFromFile(dirName.String());
-
-	if (status != B_OK) {
-		// look in common-etc folder (/boot/home/config/etc):
-		BPath commonEtcPath;
-		find_directory(B_USER_ETC_DIRECTORY, &commonEtcPath);
-		if (commonEtcPath.InitCheck() == B_OK) {
-			dirName = BString(commonEtcPath.Path())
-							<< "/" << catalogName;
-			status = ReadFromFile(dirName.String());
+	catalog_index().GetNativeName(language, fLanguageName);
+
+	// The locale kit tries every preferred language for every application,
+	// so where each catalog is, or that it doesn't exist, is remembered.
+	std::vector<BString> paths;
+	catalog_index().FindCatalog(catalog_folders(), owner,
+		fLanguageName.String(), fingerprint, paths, fProbeCount);
+
+	if ((catalog_options() & kOptionAsync) != 0 && !paths.empty()) {
+		fLoaded = false;
+		try {
+			fLoadThread = std::thread(&AmigaCatalog::_Load, this, paths,
+				fSignature, fLanguageName);
+		} catch (const std::system_error&) {
+			// Load it right away instead
+			_Load(paths, fSignature, fLanguageName);
 		}
+		fInitCheck = B_OK;
+		return;
 	}
 
-	if (status != B_OK) {
-		// look in system-etc folder (/boot/beos/etc):
-		BPath systemEtcPath;
-		find_directory(B_SYSTEM_ETC_DIRECTORY, &systemEtcPath);
-		if (systemEtcPath.InitCheck() == B_OK) {
-			dirName = BString(systemEtcPath.Path())
-							<< "/" << catalogName;
-			status = ReadFromFile(dirName.String());
-		}
-	}
+	status_t status = B_ENTRY_NOT_FOUND;
+	for (size_t i = 0; i < paths.size() && status != B_OK; i++)
+		status = ReadFromFile(paths[i].String());
+
+	// Lookups from any number of threads must not contend, unless strings
+	// are to be decoded as they are used
+	if (status == B_OK && !fLoadLazily)
+		status = Freeze();
+
+	if (status == B_OK && (catalog_options() & kOptionReload) != 0)
+		_StartWatching(fPath);
 
 	fInitCheck = status;
 }
@@ -129,7 +272,16 @@ AmigaCatalog::AmigaCatalog(const char *path, const char *signature,
 	const char *language)
 	:
 	HashMapCatalog(signature, language, 0),
-	fPath(path)
+	fPath(path),
+	fSource(NULL),
+	fSharedImage(NULL),
+	fLoadLazily(false),
+	fUseCache(false),
+	fProbeCount(0),
+	fLoaded(true),
+	fLoadedCatalog(NULL),
+	fTable(&fStrings),
+	fWatcher(NULL)
 {
 	fInitCheck = B_OK;
 }
@@ -137,6 +289,213 @@ AmigaCatalog::AmigaCatalog(const char *path, const char *signature,
 
 AmigaCatalog::~AmigaCatalog()
 {
+	_WaitForLoad();
+
+	if (fWatcher != NULL)
+		fWatcher->Stop();
+	for (size_t i = 0; i < fReloadedCatalogs.size(); i++)
+		delete fReloadedCatalogs[i];
+
+	fStrings.MakeEmpty();
+	delete fSource;
+	delete fSharedImage;
+}
+
+
+const char *
+AmigaCatalog::GetString(uint32 id)
+{
+	if (!fLoaded.load(std::memory_order_acquire))
+		_WaitForLoad();
+
+	// Strings set through the editor interface live in the hash map, and
+	// replace the ones read from the file.
+	if (HashMapCatalog::CountItems() > 0) {
+		const char *string = HashMapCatalog::GetString(id);
+		if (string != NULL)
+			return string;
+	}
+
+	// With the reload option, a changed file is only loaded again once a
+	// lookup asks for it, after which new lookups get the new strings.
+	if (fWatcher != NULL)
+		fWatcher->Update();
+
+	return fTable.load(std::memory_order_acquire)->Lookup(id);
+}
+
+
+int32
+AmigaCatalog::CountItems() const
+{
+	const_cast<AmigaCatalog*>(this)->_WaitForLoad();
+	const IDStringTable *strings = fTable.load(std::memory_order_acquire);
+	int32 count = strings->CountItems();
+	if (HashMapCatalog::CountItems() == 0)
+		return count;
+
+	// Strings set through the editor interface may replace ones of the
+	// table, which are only counted once.
+	CatWalker walker;
+	if (const_cast<AmigaCatalog*>(this)->GetWalker(&walker) != B_OK)
+		return count + HashMapCatalog::CountItems();
+	for (; !walker.AtEnd(); walker.Next()) {
+		const CatKey &key = walker.GetKey();
+		if (key.fString.Length() > 0 || !strings->Contains(key.fHashVal))
+			count++;
+	}
+	return count;
+}
+
+
+int32
+AmigaCatalog::CountDecodedItems() const
+{
+	const_cast<AmigaCatalog*>(this)->_WaitForLoad();
+	return fTable.load(std::memory_order_acquire)->CountDecodedItems();
+}
+
+
+status_t
+AmigaCatalog::Freeze()
+{
+	_WaitForLoad();
+	return fTable.load(std::memory_order_acquire)->Freeze() ? B_OK
+		: B_NO_MEMORY;
+}
+
+
+int32
+AmigaCatalog::CountProbes() const
+{
+	return fProbeCount;
+}
+
+
+/*
+ * reads the first valid catalog of the list into a new, separate catalog.
+ */
+AmigaCatalog *
+AmigaCatalog::_ReadCatalog(const std::vector<BString>& paths,
+	const BString& signature, const BString& language) const
+{
+	AmigaCatalog *catalog = new(std::nothrow) AmigaCatalog("",
+		signature.String(), language.String());
+	if (catalog == NULL)
+		return NULL;
+
+	catalog->fLoadLazily = fLoadLazily;
+	catalog->fUseCache = fUseCache;
+
+	status_t status = B_ENTRY_NOT_FOUND;
+	for (size_t i = 0; i < paths.size() && status != B_OK; i++)
+		status = catalog->ReadFromFile(paths[i].String());
+	if (status == B_OK && !fLoadLazily)
+		status = catalog->Freeze();
+
+	if (status != B_OK) {
+		delete catalog;
+		return NULL;
+	}
+	return catalog;
+}
+
+
+/*
+ * runs on the loading thread. Nothing in this catalog is touched until
+ * _WaitForLoad().
+ */
+void
+AmigaCatalog::_Load(std::vector<BString> paths, BString signature,
+	BString language)
+{
+	fLoadedCatalog = _ReadCatalog(paths, signature, language);
+	if (fLoadedCatalog != NULL && (catalog_options() & kOptionReload) != 0)
+		_StartWatching(fLoadedCatalog->fPath);
+}
+
+
+/*
+ * waits for the loading thread, if there is one, and takes over the strings
+ * it read. The signature and language name identified the catalog file and
+ * are kept, so they don't change under other threads.
+ */
+void
+AmigaCatalog::_WaitForLoad()
+{
+	if (fLoaded.load(std::memory_order_acquire))
+		return;
+
+	std::lock_guard<std::mutex> locker(fLoadLock);
+	if (fLoaded.load(std::memory_order_relaxed))
+		return;
+
+	if (fLoadThread.joinable())
+		fLoadThread.join();
+
+	if (fLoadedCatalog != NULL) {
+		fStrings.Swap(fLoadedCatalog->fStrings);
+		std::swap(fSource, fLoadedCatalog->fSource);
+		std::swap(fSharedImage, fLoadedCatalog->fSharedImage);
+		fPath = fLoadedCatalog->fPath;
+		fFingerprint = fLoadedCatalog->fFingerprint;
+
+		delete fLoadedCatalog;
+		fLoadedCatalog = NULL;
+	}
+
+	fLoaded.store(true, std::memory_order_release);
+}
+
+
+void
+AmigaCatalog::_StartWatching(const BString& path)
+{
+	CatalogWatcher *watcher = new(std::nothrow) CatalogWatcher(path.String(),
+		std::bind(&AmigaCatalog::_Reload, this));
+	if (watcher == NULL)
+		return;
+
+	if (watcher->Start() != B_OK) {
+		watcher->Stop();
+		return;
+	}
+	fWatcher = watcher;
+}
+
+
+/*
+ * called on the watcher thread when the catalog file changed. The new
+ * strings are read into a separate catalog, and published with a single
+ * pointer store, so lookups never wait nor see a partially loaded table.
+ * Lookups may still be using the previous tables, and the application the
+ * strings it got from them, so they are all kept until the catalog is
+ * deleted. Memory is bounded by only reloading when a lookup happened after
+ * the file changed, and at most kMaxReloadCount times.
+ */
+void
+AmigaCatalog::_Reload()
+{
+	_WaitForLoad();
+
+	if (fReloadedCatalogs.size() >= kMaxReloadCount)
+		return;
+
+	AmigaCatalog *catalog = _ReadCatalog(std::vector<BString>(1, fPath),
+		fSignature, fLanguageName);
+	if (catalog == NULL) {
+		// The file is probably still being written, there will be another
+		// notification once it's done.
+		return;
+	}
+
+	try {
+		fReloadedCatalogs.push_back(catalog);
+	} catch (const std::bad_alloc&) {
+		delete catalog;
+		return;
+	}
+	fTable.store(&catalog->fStrings, std::memory_order_release);
 }
 
 
@@ -146,108 +505,233 @@ AmigaCatalog::ReadFromFile(const char *path)
 	if (!path)
 		path = fPath.String();
 
-	BFile source(path, B_READ_ONLY);
-	if (source.InitCheck() != B_OK)
-		return source.InitCheck();
-
-	// Now read all the data from the file
-
-	int32 tmp;
-	source.Read(&tmp, sizeof(tmp)); // IFF header
-	if (ntohl(tmp) != 'FORM')
-		return B_BAD_DATA;
-
-	int32 dataSize;
-	source.Read(&dataSize, sizeof(dataSize)); // File size
-	dataSize = ntohl(dataSize);
-	source.Read(&tmp, sizeof(tmp)); // File type
-	if (ntohl(tmp) != 'CTLG')
-		return B_BAD_DATA;
-
-	dataSize -= 4; // Type is included in data size.
-
-	while(dataSize > 0) {
-		int32 chunkID, chunkSize;
-		source.Read(&chunkID, sizeof(chunkID));
-		source.Read(&chunkSize, sizeof(chunkSize));
-		chunkSize = ntohl(chunkSize);
-
-		// Round to word
-		if (chunkSize & 1) chunkSize++;
-
-		BStackOrHeapArray<char, 256> chunkData(chunkSize);
-		source.Read(chunkData, chunkSize);
-
-		chunkID = ntohl(chunkID);
-
-		switch(chunkID) {
-			case 'FVER': // Version
-				fSignature = chunkData;
-				break;
-			case 'LANG': // Language
-				fLanguageName = chunkData;
-				break;
-
-			case 'STRS': // Catalog strings
-			{
-				BMemoryIO strings(chunkData, chunkSize);
-				int32 strID, strLen;
-
-				while (strings.Position() < chunkSize) {
-					strings.Read(&strID, sizeof(strID));
-					strings.Read(&strLen, sizeof(strLen));
-					strID = ntohl(strID);
-					strLen = ntohl(strLen);
-					if (strLen & 3) {
-						strLen &= ~3;
-						strLen += 4;
-					}
-					char strBase[strLen];
-					char* strVal = strBase;
-					strings.Read(strBase, strLen);
-
-					if (strBase[1] == 0)
-					{
-						// Skip the \0 marker for menu entries…
-						strLen -= 2;
-						strVal += 2;
-					}
-
-					char outVal[1024];
-					int32 outLen = 1024;
-					int32 cookie = 0;
-
-					convert_to_utf8(B_ISO1_CONVERSION, strVal, &strLen,
-						outVal, &outLen, &cookie);
-
-					// If the UTF-8 version is shorter, it's likely that
-					// something went wrong. Keep the original string.
-					if (outLen > strLen)
-						SetString(strID, outVal);
-					else
-						SetString(strID, strVal);
-				}
-				break;
-			}
-
-			case 'CSET': // Unknown/unused
-			default:
-				break;
-		}
-		
-		dataSize -= chunkSize + 8;
+	// Applications load catalogs from the decoded cache, or from another
+	// process through shared memory, when it is up to date, and skip
+	// parsing entirely.
+	BPath cacheDirectory;
+	bool hasCacheDirectory
+		= find_directory(B_USER_CACHE_DIRECTORY, &cacheDirectory) == B_OK
+			&& cacheDirectory.Append(kCacheFolder) == B_OK;
+	CatalogCache cache(hasCacheDirectory ? cacheDirectory.Path() : NULL,
+		path);
+	if (fUseCache && _ReadFromCache(cache)) {
+		fPath = path;
+		return B_OK;
 	}
 
+	// Map the whole file at once and walk the chunks in place, so loading
+	// costs no read syscalls and no intermediate copies. Files on volumes
+	// that can't be mapped are streamed through a small buffer instead.
+	// Lazy tables keep using the file after loading, and with the reload
+	// option it may still be written while it is loaded. Truncating a mapped
+	// file would then fault, and rewriting it change strings under the
+	// table, so it is read into memory of its own instead.
+	bool copy = fLoadLazily || (catalog_options() & kOptionReload) != 0;
+	MappedFile* source = new(std::nothrow) MappedFile(path,
+		copy ? MappedFile::kRead : MappedFile::kMapOnly);
+	if (source == NULL)
+		return B_NO_MEMORY;
+	ObjectDeleter<MappedFile> sourceDeleter(source);
+
+	// Strings go to a separate table, so the catalog is left untouched if
+	// the file turns out to be invalid.
+	IDStringTable strings;
+
+	// When loading lazily, strings are converted on first lookup, and the
+	// copy of the file is kept for the lifetime of the catalog. The cache needs
+	// every string decoded, so it is only written otherwise.
+	// The cache is keyed by the file as it was before reading it. If it
+	// changes meanwhile, the cache is outdated already and won't be used.
+	bool lazy = false;
+	struct stat catalogStat;
+	status_t status;
+	if (source->InitCheck() == 0) {
+		catalogStat = source->Stat();
+		lazy = fLoadLazily;
+		status = _ReadMapped(*source, strings, lazy);
+	} else
+		status = _ReadStreamed(path, strings, catalogStat);
+	if (status != B_OK)
+		return status;
+
+	if (!strings.Finish())
+		return B_NO_MEMORY;
+	fStrings.Swap(strings);
+
+	delete fSource;
+	fSource = lazy ? sourceDeleter.Detach() : NULL;
+
 	fPath = path;
-	fFingerprint = ComputeFingerprint();
+	fFingerprint = fStrings.Fingerprint();
+
+	if (fUseCache && !lazy)
+		_WriteToCache(cache, catalogStat);
 	return B_OK;
 }
 
 
+/*
+ * walks the chunks of a mapped catalog file in place. Only the position of
+ * each string is recorded, they are converted by Finish() or, for lazy
+ * tables, on first lookup.
+ */
+status_t
+AmigaCatalog::_ReadMapped(const MappedFile& source, IDStringTable& strings,
+	bool lazy)
+{
+	strings.SetParallelThreshold(kParallelDecodeThreshold);
+
+	std::string version(fSignature.String());
+	std::string language(fLanguageName.String());
+	int error = read_mapped_catalog(source.Data(), source.Size(), strings,
+		lazy, version, language);
+	if (error != 0)
+		return error == EINVAL ? B_BAD_DATA : error;
+
+	fSignature = version.c_str();
+	fLanguageName = language.c_str();
+	return B_OK;
+}
+
+
+/*
+ * reads a catalog file that can't be mapped through a fixed size window,
+ * converting the strings as they arrive. catalogStat is set to the status
+ * of the file before reading it.
+ */
+status_t
+AmigaCatalog::_ReadStreamed(const char* path, IDStringTable& strings,
+	struct stat& catalogStat)
+{
+	int fd = open(path, O_RDONLY);
+	if (fd < 0)
+		return errno;
+	if (fstat(fd, &catalogStat) != 0) {
+		status_t error = errno;
+		close(fd);
+		return error;
+	}
+
+	std::string version(fSignature.String());
+	std::string language(fLanguageName.String());
+	int error = read_streamed_catalog(fd, strings, version, language);
+	close(fd);
+	if (error != 0)
+		return error == EINVAL ? B_BAD_DATA : error;
+
+	fSignature = version.c_str();
+	fLanguageName = language.c_str();
+	return B_OK;
+}
+
+
+/*
+ * loads the strings from the cache file, or from shared memory, if they are
+ * up to date with the catalog file. The table then uses them in place.
+ */
+bool
+AmigaCatalog::_ReadFromCache(CatalogCache& cache)
+{
+	IDStringTable strings;
+	std::string version;
+	std::string language;
+	uint32_t fingerprint;
+
+	MappedFile* file = cache.Load(strings, version, language, fingerprint);
+	SharedImage* image = NULL;
+	if (file == NULL) {
+		image = cache.Attach(strings, version, language, fingerprint);
+		if (image == NULL)
+			return false;
+	}
+
+	fStrings.Swap(strings);
+	delete fSource;
+	fSource = file;
+	delete fSharedImage;
+	fSharedImage = image;
+
+	fSignature = version.c_str();
+	fLanguageName = language.c_str();
+	fFingerprint = fingerprint;
+	return true;
+}
+
+
+/*
+ * stores the decoded strings in the cache. If that's not possible, they are
+ * published in shared memory instead, so other instances of the application
+ * can still skip parsing the catalog while this one is running.
+ */
+void
+AmigaCatalog::_WriteToCache(CatalogCache& cache,
+	const struct stat& catalogStat)
+{
+	if (cache.Store(catalogStat, fStrings, fSignature.String(),
+			fLanguageName.String(), fFingerprint))
+		return;
+
+	delete fSharedImage;
+	fSharedImage = cache.Publish(catalogStat, fStrings, fSignature.String(),
+		fLanguageName.String(), fFingerprint);
+}
+
+
 status_t
 AmigaCatalog::WriteToFile(const char *path)
 {
-	return B_NOT_SUPPORTED;
+	if (path)
+		fPath = path;
+
+	_WaitForLoad();
+
+	// After a reload, the current strings are not in fStrings anymore.
+	// Menu shortcuts were dropped from them while reading, so they are
+	// lost when a catalog is written back.
+	CTLGWriter writer(fSignature.String(), fLanguageName.String());
+	if (!add_table_strings(writer, *fTable.load(std::memory_order_acquire)))
+		return B_NO_MEMORY;
+
+	// Strings set through the editor interface come last, so they replace
+	// the ones read from the file. Amiga catalogs can only hold strings
+	// identified by ID.
+	CatWalker walker;
+	status_t status = GetWalker(&walker);
+	if (status != B_OK)
+		return status;
+	for (; !walker.AtEnd(); walker.Next()) {
+		const CatKey &key = walker.GetKey();
+		if (key.fString.Length() > 0)
+			continue;
+
+		const char *string = walker.GetValue();
+		if (!writer.AddString(key.fHashVal, string, strlen(string)))
+			return B_NO_MEMORY;
+	}
+
+	// The whole file is built in memory, and written with a single call.
+	std::vector<uint8_t> buffer;
+	if (!writer.Flatten(buffer))
+		return B_NO_MEMORY;
+	fFingerprint = writer.Fingerprint();
+
+	BFile catalogFile(fPath.String(),
+		B_WRITE_ONLY | B_CREATE_FILE | B_ERASE_FILE);
+	status = catalogFile.InitCheck();
+	if (status != B_OK)
+		return status;
+
+	ssize_t written = catalogFile.Write(&buffer[0], buffer.size());
+	if (written < 0)
+		return written;
+	if ((size_t)written != buffer.size())
+		return B_IO_ERROR;
+
+	UpdateAttributes(catalogFile);
+
+	// The catalog may have been installed where lookups were cached
+	catalog_index().Invalidate();
+	return B_OK;
 }
 
 
@@ -260,7 +744,6 @@ AmigaCatalog::UpdateAttributes(BFile& catalogFile)
 {
 	static const int bufSize = 256;
 	char buf[bufSize];
-	uint32 temp;
 	if (catalogFile.ReadAttr("BEOS:TYPE", B_MIME_STRING_TYPE, 0, &buf, bufSize)
 			<= 0
 		|| strcmp(kCatMimeType, buf) != 0) {
@@ -279,11 +762,10 @@ AmigaCatalog::UpdateAttributes(BFile& catalogFile)
 		catalogFile.WriteAttr(BLocaleRoster::kCatSigAttr, B_STRING_TYPE, 0,
 			fSignature.String(), fSignature.Length()+1);
 	}
-	if (catalogFile.ReadAttr(BLocaleRoster::kCatFingerprintAttr, B_UINT32_TYPE,
-		0, &temp, sizeof(uint32)) <= 0) {
-		catalogFile.WriteAttr(BLocaleRoster::kCatFingerprintAttr, B_UINT32_TYPE,
-			0, &fFingerprint, sizeof(uint32));
-	}
+	// The fingerprint changes with every string added, an existing
+	// attribute is most likely stale.
+	catalogFile.WriteAttr(BLocaleRoster::kCatFingerprintAttr, B_UINT32_TYPE,
+		0, &fFingerprint, sizeof(uint32));
 }
 
 
@@ -335,8 +817,23 @@ get_available_languages(BMessage* availableLanguages,
 	const char* sigPattern = NULL, const char* langPattern = NULL,
 	int32 fingerprint = 0)
 {
-	// TODO
-	return B_ERROR;
+	// Amiga catalogs are identified by ID, the fingerprint of the
+	// application is not checked when loading them either.
+	return catalog_index().GetAvailableLanguages(availableLanguages,
+		catalog_folders(), sigPattern, langPattern);
+}
+
+
+/*
+ * forgets where catalogs were found, or that they were missing. Installing
+ * or removing a catalog is reported by the node monitor anyway, this is only
+ * needed after changes that leave the folders alone, like fixing the
+ * attributes of an existing catalog file.
+ */
+extern "C" void
+invalidate_catalog_index()
+{
+	catalog_index().Invalidate();
 }
 
 
@@ -10,12 +10,26 @@
 #include <DataIO.h>
 #include <String.h>
 
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "StringTable.h"
+
 
 class BFile;
+struct stat;
 
 namespace BPrivate {
 
 
+class CatalogCache;
+class CatalogWatcher;
+class MappedFile;
+class SharedImage;
+
+
 class AmigaCatalog : public HashMapCatalog {
 	public:
 		AmigaCatalog(const entry_ref &owner, const char *language,
@@ -27,6 +41,25 @@ class AmigaCatalog : public HashMapCatalog {
 
 		~AmigaCatalog();
 
+		// overrides of HashMapCatalog, IDs are also looked up in fStrings:
+		using HashMapCatalog::GetString;
+		const char *GetString(uint32 id);
+		int32 CountItems() const;
+
+		int32 CountDecodedItems() const;
+			// strings actually converted so far, for lazily loaded catalogs
+		int32 CountProbes() const;
+			// files and folders looked up to find the catalog, none when
+			// it was known already
+
+		status_t Freeze();
+			// Decodes whatever was not yet, after which GetString(uint32)
+			// is wait-free and only reads memory, so any number of threads
+			// can use it without contending. Catalogs loaded by
+			// applications are frozen, unless they use the lazy option.
+			// With the async option, the first lookup still waits for
+			// loading.
+
 		// implementation for editor-interface:
 		status_t ReadFromFile(const char *path = NULL);
 		status_t WriteToFile(const char *path = NULL);
@@ -40,7 +73,45 @@ class AmigaCatalog : public HashMapCatalog {
 		void UpdateAttributes(BFile& catalogFile);
 		void UpdateAttributes(const char* path);
 
+		status_t _ReadMapped(const MappedFile& source,
+			IDStringTable& strings, bool lazy);
+		status_t _ReadStreamed(const char* path, IDStringTable& strings,
+			struct stat& catalogStat);
+		AmigaCatalog* _ReadCatalog(const std::vector<BString>& paths,
+			const BString& signature, const BString& language) const;
+		void _Load(std::vector<BString> paths, BString signature,
+			BString language);
+		void _WaitForLoad();
+		void _StartWatching(const BString& path);
+		void _Reload();
+
+		bool _ReadFromCache(CatalogCache& cache);
+		void _WriteToCache(CatalogCache& cache,
+			const struct stat& catalogStat);
+
 		mutable BString		fPath;
+		IDStringTable		fStrings;
+		MappedFile*			fSource;
+			// a copy of the catalog file while strings are decoded
+			// lazily, or the mapped cache file fStrings uses
+		SharedImage*		fSharedImage;
+			// while fStrings uses an image in shared memory, or to keep
+			// the one we published available
+		bool				fLoadLazily;
+		bool				fUseCache;
+		int32				fProbeCount;
+
+		// with the async option, while the catalog is loading
+		std::atomic<bool>	fLoaded;
+		std::mutex			fLoadLock;
+		std::thread			fLoadThread;
+		AmigaCatalog*		fLoadedCatalog;
+
+		// the strings lookups use: fStrings, or the last reloaded catalog's
+		std::atomic<IDStringTable*>	fTable;
+		CatalogWatcher*		fWatcher;
+		std::vector<AmigaCatalog*> fReloadedCatalogs;
+			// only used by the watcher thread
 };
 
 
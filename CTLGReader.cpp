@@ -0,0 +1,353 @@
+/*
+ * Copyright 2026, Adrien Destugues, pulkomandy@pulkomandy.tk.
+ * Distributed under the terms of the MIT License.
+ */
+
+#include "CTLGReader.h"
+
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+
+using BPrivate::CTLGChunkIterator;
+using BPrivate::CTLGStreamReader;
+using BPrivate::CTLGStringIterator;
+using BPrivate::ctlg_read_uint32;
+
+
+CTLGChunkIterator::CTLGChunkIterator(const uint8_t* data, size_t size)
+	:
+	fPosition(NULL),
+	fEnd(NULL),
+	fError(true)
+{
+	if (size < 12 || ctlg_read_uint32(data) != 'FORM'
+		|| ctlg_read_uint32(data + 8) != 'CTLG')
+		return;
+
+	// The FORM size includes the type, but not the FORM header.
+	size_t dataSize = ctlg_read_uint32(data + 4);
+	if (dataSize < 4 || dataSize > size - 8)
+		return;
+
+	fPosition = data + 12;
+	fEnd = data + 8 + dataSize;
+	fError = false;
+}
+
+
+bool
+CTLGChunkIterator::Next(CTLGChunk& chunk)
+{
+	if (fError || fEnd - fPosition < 8)
+		return false;
+
+	chunk.id = ctlg_read_uint32(fPosition);
+	chunk.size = ctlg_read_uint32(fPosition + 4);
+	chunk.data = fPosition + 8;
+
+	if (chunk.size > (size_t)(fEnd - fPosition) - 8) {
+		fError = true;
+		return false;
+	}
+
+	// Chunks are padded to a word boundary
+	fPosition += 8 + chunk.size;
+	if ((chunk.size & 1) != 0 && fPosition < fEnd)
+		fPosition++;
+	return true;
+}
+
+
+/*!	Returns the length of the string data including its padding, limited to
+	what is left of the chunk.
+*/
+static inline size_t
+padded_string_length(size_t length, size_t remaining)
+{
+	size_t padded = (length + 3) & ~(size_t)3;
+	return padded < remaining ? padded : remaining;
+}
+
+
+static inline void
+set_string_value(BPrivate::CTLGString& string, const char* value,
+	size_t length)
+{
+	if (length > 2 && value[1] == '\0') {
+		// Skip the \0 marker for menu entries…
+		length -= 2;
+		value += 2;
+	}
+
+	string.string = value;
+	string.length = strnlen(value, length);
+}
+
+
+// #pragma mark -
+
+
+CTLGStringIterator::CTLGStringIterator(const uint8_t* data, size_t size)
+	:
+	fPosition(data),
+	fEnd(data + size),
+	fError(false)
+{
+}
+
+
+CTLGStringIterator::CTLGStringIterator(const CTLGChunk& chunk)
+	:
+	fPosition(chunk.data),
+	fEnd(chunk.data + chunk.size),
+	fError(false)
+{
+}
+
+
+bool
+CTLGStringIterator::Next(CTLGString& string)
+{
+	if (fError || fEnd - fPosition < 8)
+		return false;
+
+	string.id = ctlg_read_uint32(fPosition);
+	size_t length = ctlg_read_uint32(fPosition + 4);
+	const char* value = (const char*)fPosition + 8;
+
+	if (length > (size_t)(fEnd - fPosition) - 8) {
+		fError = true;
+		return false;
+	}
+
+	// Each entry is padded so the next one starts on a DWORD boundary
+	fPosition += 8 + padded_string_length(length, fEnd - fPosition - 8);
+
+	set_string_value(string, value, length);
+	return true;
+}
+
+
+// #pragma mark -
+
+
+CTLGStreamReader::CTLGStreamReader(int fd, size_t windowSize)
+	:
+	fFD(fd),
+	fBuffer(NULL),
+	fWindowSize(windowSize < kCTLGMinWindowSize
+		? kCTLGMinWindowSize : windowSize),
+	fCapacity(fWindowSize),
+	fStart(0),
+	fEnd(0),
+	fFormRemaining(0),
+	fChunkRemaining(0),
+	fChunkPadding(0),
+	fInStrings(false),
+	fError(true)
+{
+	fBuffer = (uint8_t*)malloc(fCapacity);
+	if (fBuffer == NULL || !_Fill(12))
+		return;
+
+	const uint8_t* header = fBuffer + fStart;
+	if (ctlg_read_uint32(header) != 'FORM'
+		|| ctlg_read_uint32(header + 8) != 'CTLG')
+		return;
+
+	// The FORM size includes the type, but not the FORM header.
+	fFormRemaining = ctlg_read_uint32(header + 4);
+	if (fFormRemaining < 4)
+		return;
+
+	fFormRemaining -= 4;
+	fStart += 12;
+	fError = false;
+}
+
+
+CTLGStreamReader::~CTLGStreamReader()
+{
+	free(fBuffer);
+}
+
+
+bool
+CTLGStreamReader::NextChunk(CTLGChunk& chunk)
+{
+	if (fError)
+		return false;
+
+	_Shrink();
+
+	// Skip whatever the caller did not read of the previous chunk
+	if (!_Skip(fChunkRemaining + fChunkPadding))
+		return false;
+	fChunkRemaining = 0;
+	fChunkPadding = 0;
+	fInStrings = false;
+
+	if (fFormRemaining < 8)
+		return false;
+	if (!_Fill(8))
+		return false;
+
+	chunk.id = ctlg_read_uint32(fBuffer + fStart);
+	chunk.size = ctlg_read_uint32(fBuffer + fStart + 4);
+	chunk.data = NULL;
+	fStart += 8;
+	fFormRemaining -= 8;
+
+	if (chunk.size > fFormRemaining) {
+		fError = true;
+		return false;
+	}
+
+	// Chunks are padded to a word boundary
+	fFormRemaining -= chunk.size;
+	fChunkRemaining = chunk.size;
+	if ((chunk.size & 1) != 0 && fFormRemaining > 0) {
+		fChunkPadding = 1;
+		fFormRemaining--;
+	}
+
+	if (chunk.id == 'STRS') {
+		fInStrings = true;
+		return true;
+	}
+
+	if (chunk.size <= fCapacity) {
+		if (!_Fill(chunk.size))
+			return false;
+		chunk.data = fBuffer + fStart;
+		fStart += chunk.size;
+		fChunkRemaining = 0;
+	}
+	return true;
+}
+
+
+bool
+CTLGStreamReader::NextString(CTLGString& string)
+{
+	if (fError || !fInStrings || fChunkRemaining < 8)
+		return false;
+
+	_Shrink();
+	if (!_Fill(8))
+		return false;
+
+	string.id = ctlg_read_uint32(fBuffer + fStart);
+	size_t length = ctlg_read_uint32(fBuffer + fStart + 4);
+
+	if (length > fChunkRemaining - 8) {
+		fError = true;
+		return false;
+	}
+
+	// Each entry is padded so the next one starts on a DWORD boundary
+	size_t entrySize = 8 + padded_string_length(length, fChunkRemaining - 8);
+	if (!_Fill(entrySize))
+		return false;
+
+	const char* value = (const char*)fBuffer + fStart + 8;
+	fStart += entrySize;
+	fChunkRemaining -= entrySize;
+
+	set_string_value(string, value, length);
+	return true;
+}
+
+
+/*!	Makes sure at least size bytes are available from fStart, reading as
+	much as fits in the window at once.
+*/
+bool
+CTLGStreamReader::_Fill(size_t size)
+{
+	if (fEnd - fStart >= size)
+		return true;
+
+	if (size > fCapacity) {
+		// A single entry larger than the window. Its size comes from the
+		// file, so it is limited before anything is allocated for it.
+		if (size > kCTLGMaxEntrySize) {
+			fError = true;
+			return false;
+		}
+
+		uint8_t* buffer = (uint8_t*)malloc(size);
+		if (buffer == NULL) {
+			fError = true;
+			return false;
+		}
+		memcpy(buffer, fBuffer + fStart, fEnd - fStart);
+		free(fBuffer);
+		fBuffer = buffer;
+		fCapacity = size;
+		fEnd -= fStart;
+		fStart = 0;
+	} else if (fStart + size > fCapacity) {
+		memmove(fBuffer, fBuffer + fStart, fEnd - fStart);
+		fEnd -= fStart;
+		fStart = 0;
+	}
+
+	while (fEnd - fStart < size) {
+		ssize_t bytesRead = read(fFD, fBuffer + fEnd, fCapacity - fEnd);
+		if (bytesRead < 0 && errno == EINTR)
+			continue;
+		if (bytesRead <= 0) {
+			fError = true;
+			return false;
+		}
+		fEnd += bytesRead;
+	}
+	return true;
+}
+
+
+bool
+CTLGStreamReader::_Skip(size_t size)
+{
+	while (size > 0) {
+		size_t available = fEnd - fStart;
+		if (available == 0) {
+			fStart = fEnd = 0;
+			if (!_Fill(size < fCapacity ? size : fCapacity))
+				return false;
+			available = fEnd - fStart;
+		}
+
+		size_t skipped = size < available ? size : available;
+		fStart += skipped;
+		size -= skipped;
+	}
+	return true;
+}
+
+
+/*!	Goes back to a buffer of the window size once the entry that needed a
+	larger one is consumed. It is kept if that fails, as it still works.
+*/
+void
+CTLGStreamReader::_Shrink()
+{
+	size_t available = fEnd - fStart;
+	if (fCapacity == fWindowSize || available > fWindowSize)
+		return;
+
+	uint8_t* buffer = (uint8_t*)malloc(fWindowSize);
+	if (buffer == NULL)
+		return;
+
+	memcpy(buffer, fBuffer + fStart, available);
+	free(fBuffer);
+	fBuffer = buffer;
+	fCapacity = fWindowSize;
+	fStart = 0;
+	fEnd = available;
+}
@@ -0,0 +1,146 @@
+/*
+ * Copyright 2026, Adrien Destugues, pulkomandy@pulkomandy.tk.
+ * Distributed under the terms of the MIT License.
+ */
+#ifndef _CTLG_READER_H_
+#define _CTLG_READER_H_
+
+
+#include <stddef.h>
+#include <stdint.h>
+
+
+/*	Platform independent parsing of IFF CTLG files. This does not depend on
+ *	any Haiku kit, so it can be built, profiled and fuzzed on other systems.
+ *	Both iterators work in place on a buffer holding the file (or chunk) and
+ *	never copy the data.
+ *
+ *	For files that can't be mapped, CTLGStreamReader parses the same data
+ *	from a file descriptor through a fixed size read-ahead window, so memory
+ *	use does not depend on the size of the catalog. A string larger than the
+ *	window gets a buffer of its own until it is consumed, and files with
+ *	strings larger than kCTLGMaxEntrySize are rejected, whatever size they
+ *	claim.
+ */
+
+
+namespace BPrivate {
+
+
+static inline uint32_t
+ctlg_read_uint32(const uint8_t* data)
+{
+	// IFF files are big-endian, and fields are not always aligned
+	return ((uint32_t)data[0] << 24) | ((uint32_t)data[1] << 16)
+		| ((uint32_t)data[2] << 8) | data[3];
+}
+
+
+static const size_t kCTLGDefaultWindowSize = 64 * 1024;
+static const size_t kCTLGMinWindowSize = 256;
+	// smaller windows are enlarged to this, so the FVER, LANG and CSET
+	// chunks of usual catalogs always fit
+static const size_t kCTLGMaxEntrySize = 1024 * 1024;
+	// for the stream reader, way more than any translation needs
+
+
+// Code sets in CSET chunks, which use IANA MIBenum values
+enum {
+	kCTLGCodeSetLatin1	= 4,
+	kCTLGCodeSetUTF8	= 106
+};
+
+
+struct CTLGChunk {
+	uint32_t		id;
+	const uint8_t*	data;
+	size_t			size;
+};
+
+
+struct CTLGString {
+	uint32_t		id;
+	const char*		string;
+	size_t			length;
+		// not including the terminating NULL, which may be missing
+};
+
+
+class CTLGChunkIterator {
+	public:
+		CTLGChunkIterator(const uint8_t* data, size_t size);
+
+		bool IsValid() const { return !fError; }
+			// false if the file is not a CTLG, or is truncated
+		bool Next(CTLGChunk& chunk);
+			// returns false at the end of the file or on error
+
+	private:
+		const uint8_t*	fPosition;
+		const uint8_t*	fEnd;
+		bool			fError;
+};
+
+
+class CTLGStringIterator {
+	public:
+		CTLGStringIterator(const uint8_t* data, size_t size);
+		CTLGStringIterator(const CTLGChunk& chunk);
+
+		bool IsValid() const { return !fError; }
+			// false if an entry runs past the end of the chunk
+		bool Next(CTLGString& string);
+			// returns false at the end of the chunk or on error
+
+	private:
+		const uint8_t*	fPosition;
+		const uint8_t*	fEnd;
+		bool			fError;
+};
+
+
+class CTLGStreamReader {
+	public:
+		CTLGStreamReader(int fd,
+			size_t windowSize = kCTLGDefaultWindowSize);
+		~CTLGStreamReader();
+
+		bool IsValid() const { return !fError; }
+			// false if the file is not a CTLG, is truncated, or can't be
+			// read
+		bool NextChunk(CTLGChunk& chunk);
+			// The data of STRS chunks is read with NextString() instead,
+			// and the one of chunks larger than the window is skipped.
+			// chunk.data is NULL in both cases, otherwise it is valid until
+			// the next call.
+		bool NextString(CTLGString& string);
+			// returns the strings of the current STRS chunk, valid until
+			// the next call
+
+	private:
+		CTLGStreamReader(const CTLGStreamReader&);
+		CTLGStreamReader& operator=(const CTLGStreamReader&);
+
+		bool _Fill(size_t size);
+		bool _Skip(size_t size);
+		void _Shrink();
+
+		int				fFD;
+		uint8_t*		fBuffer;
+		size_t			fWindowSize;
+		size_t			fCapacity;
+			// the window size, unless a single entry needed more
+		size_t			fStart;
+		size_t			fEnd;
+		size_t			fFormRemaining;
+		size_t			fChunkRemaining;
+		size_t			fChunkPadding;
+		bool			fInStrings;
+		bool			fError;
+};
+
+
+} // namespace BPrivate
+
+
+#endif /* _CTLG_READER_H_ */
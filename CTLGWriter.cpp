@@ -0,0 +1,159 @@
+/*
+ * Copyright 2026, Adrien Destugues, pulkomandy@pulkomandy.tk.
+ * Distributed under the terms of the MIT License.
+ */
+
+#include "CTLGWriter.h"
+
+#include <string.h>
+
+#include <algorithm>
+#include <new>
+
+#include "CharsetConversion.h"
+#include "CTLGReader.h"
+
+
+using BPrivate::CTLGWriter;
+
+
+static const size_t kCodeSetChunkSize = 32;
+	// the code set, followed by 7 reserved longs
+
+
+static inline uint8_t*
+write_uint32(uint8_t* target, uint32_t value)
+{
+	target[0] = value >> 24;
+	target[1] = value >> 16;
+	target[2] = value >> 8;
+	target[3] = value;
+	return target + 4;
+}
+
+
+static inline uint8_t*
+write_chunk_header(uint8_t* target, uint32_t id, size_t size)
+{
+	target = write_uint32(target, id);
+	return write_uint32(target, size);
+}
+
+
+static inline size_t
+padded_chunk_size(size_t size)
+{
+	return 8 + size + (size & 1);
+}
+
+
+CTLGWriter::CTLGWriter(const char* version, const char* language)
+	:
+	fVersion(version),
+	fLanguage(language),
+	fCodeSet(0),
+	fFingerprint(0)
+{
+}
+
+
+bool
+CTLGWriter::AddString(uint32_t id, const char* string, size_t length)
+{
+	Entry entry = { id, string, length, 0 };
+	try {
+		fEntries.push_back(entry);
+	} catch (const std::bad_alloc&) {
+		return false;
+	}
+	return true;
+}
+
+
+bool
+CTLGWriter::Flatten(std::vector<uint8_t>& buffer)
+{
+	// Keep the last occurence of duplicate IDs
+	std::stable_sort(fEntries.begin(), fEntries.end(), _CompareEntries);
+	size_t count = 0;
+	fFingerprint = 0;
+	for (size_t i = 0; i < fEntries.size(); i++) {
+		if (count > 0 && fEntries[count - 1].id == fEntries[i].id)
+			count--;
+		else
+			fFingerprint += fEntries[i].id;
+		fEntries[count++] = fEntries[i];
+	}
+	fEntries.resize(count);
+
+	// Compute the size of everything first
+	bool latin1 = fCodeSet == 0;
+	for (size_t i = 0; i < count && latin1; i++) {
+		latin1 = utf8_to_latin1(fEntries[i].string, fEntries[i].length, NULL,
+			fEntries[i].storedLength);
+	}
+
+	size_t stringsSize = 0;
+	for (size_t i = 0; i < count; i++) {
+		Entry& entry = fEntries[i];
+		if (!latin1)
+			entry.storedLength = entry.length;
+
+		// The length includes the terminating NULL, and entries are padded
+		// to the next DWORD
+		stringsSize += 8 + ((entry.storedLength + 1 + 3) & ~(size_t)3);
+	}
+
+	size_t versionSize = strlen(fVersion) + 1;
+	size_t languageSize = strlen(fLanguage) + 1;
+	size_t formSize = 4 + padded_chunk_size(versionSize)
+		+ padded_chunk_size(languageSize)
+		+ padded_chunk_size(kCodeSetChunkSize)
+		+ padded_chunk_size(stringsSize);
+	if (formSize > UINT32_MAX - 8)
+		return false;
+
+	try {
+		buffer.assign(8 + formSize, 0);
+	} catch (const std::bad_alloc&) {
+		return false;
+	}
+
+	// Then fill the buffer in a single pass. It is zeroed already, which
+	// takes care of all the padding.
+	uint8_t* target = &buffer[0];
+	target = write_chunk_header(target, 'FORM', formSize);
+	target = write_uint32(target, 'CTLG');
+
+	target = write_chunk_header(target, 'FVER', versionSize);
+	memcpy(target, fVersion, versionSize);
+	target += versionSize + (versionSize & 1);
+
+	target = write_chunk_header(target, 'LANG', languageSize);
+	memcpy(target, fLanguage, languageSize);
+	target += languageSize + (languageSize & 1);
+
+	target = write_chunk_header(target, 'CSET', kCodeSetChunkSize);
+	uint32_t codeSet = fCodeSet;
+	if (codeSet == 0)
+		codeSet = latin1 ? kCTLGCodeSetLatin1 : kCTLGCodeSetUTF8;
+	write_uint32(target, codeSet);
+	target += kCodeSetChunkSize;
+
+	target = write_chunk_header(target, 'STRS', stringsSize);
+	for (size_t i = 0; i < count; i++) {
+		const Entry& entry = fEntries[i];
+		target = write_uint32(target, entry.id);
+		target = write_uint32(target, entry.storedLength + 1);
+
+		size_t length;
+		if (latin1) {
+			utf8_to_latin1(entry.string, entry.length, (char*)target,
+				length);
+		} else
+			memcpy(target, entry.string, entry.length);
+		target += (entry.storedLength + 1 + 3) & ~(size_t)3;
+	}
+
+	return true;
+}
@@ -0,0 +1,67 @@
+/*
+ * Copyright 2026, Adrien Destugues, pulkomandy@pulkomandy.tk.
+ * Distributed under the terms of the MIT License.
+ */
+#ifndef _CTLG_WRITER_H_
+#define _CTLG_WRITER_H_
+
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <vector>
+
+
+namespace BPrivate {
+
+
+/*	Builds an IFF CTLG file from UTF-8 strings. The size of every chunk is
+ *	known before anything is written, so the file is flattened in one pass
+ *	into a buffer of the exact size, ready to be written with a single call.
+ *
+ *	Strings are stored as ISO-8859-1, which all Amiga systems understand,
+ *	unless some of them can't be represented in it. The whole catalog is
+ *	then stored as UTF-8, and the CSET chunk says so. Strings already in
+ *	another code set can be stored as they are with SetCodeSet().
+ */
+class CTLGWriter {
+	public:
+		CTLGWriter(const char* version, const char* language);
+
+		bool AddString(uint32_t id, const char* string, size_t length);
+			// The string is not copied, and must stay valid until the
+			// catalog is flattened. A later string with the same ID
+			// replaces the earlier one.
+
+		void SetCodeSet(uint32_t codeSet) { fCodeSet = codeSet; }
+			// Stores the strings without converting them, and this IANA
+			// MIBenum in the CSET chunk. 0, the default, converts them
+			// from UTF-8 as described above.
+
+		bool Flatten(std::vector<uint8_t>& buffer);
+		uint32_t Fingerprint() const { return fFingerprint; }
+			// of the flattened catalog, as AmigaCatalog computes it
+
+	private:
+		struct Entry {
+			uint32_t	id;
+			const char*	string;
+			size_t		length;
+			size_t		storedLength;
+		};
+
+		static bool _CompareEntries(const Entry& a, const Entry& b)
+			{ return a.id < b.id; }
+
+		const char*			fVersion;
+		const char*			fLanguage;
+		std::vector<Entry>	fEntries;
+		uint32_t			fCodeSet;
+		uint32_t			fFingerprint;
+};
+
+
+} // namespace BPrivate
+
+
+#endif /* _CTLG_WRITER_H_ */
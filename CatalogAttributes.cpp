@@ -0,0 +1,109 @@
+/*
+ * Copyright 2026, Adrien Destugues, pulkomandy@pulkomandy.tk.
+ * Distributed under the terms of the MIT License.
+ */
+
+#include "CatalogAttributes.h"
+
+#include <string.h>
+#include <strings.h>
+
+#include <string>
+
+#ifdef __HAIKU__
+#	include <fs_attr.h>
+#	include <TypeConstants.h>
+#else
+#	include <sys/types.h>
+#	include <sys/xattr.h>
+
+enum {
+	B_MIME_STRING_TYPE	= 'MIMS',
+	B_STRING_TYPE		= 'CSTR',
+	B_UINT32_TYPE		= 'ULNG'
+};
+#endif
+
+
+// same as BLocaleRoster::kCatLangAttr, kCatSigAttr and kCatFingerprintAttr
+static const char* kTypeAttribute = "BEOS:TYPE";
+static const char* kLanguageAttribute = "BEOS:LOCALE_LANGUAGE";
+static const char* kSignatureAttribute = "BEOS:LOCALE_SIGNATURE";
+static const char* kFingerprintAttribute = "BEOS:LOCALE_FINGERPRINT";
+
+
+static ssize_t
+read_attribute(int fd, const char* name, uint32_t type, void* buffer,
+	size_t size)
+{
+#ifdef __HAIKU__
+	return fs_read_attr(fd, name, type, 0, buffer, size);
+#else
+	std::string userName = std::string("user.") + name;
+	return fgetxattr(fd, userName.c_str(), buffer, size);
+#endif
+}
+
+
+static bool
+write_attribute(int fd, const char* name, uint32_t type, const void* data,
+	size_t size)
+{
+#ifdef __HAIKU__
+	return fs_write_attr(fd, name, type, 0, data, size) == (ssize_t)size;
+#else
+	std::string userName = std::string("user.") + name;
+	return fsetxattr(fd, userName.c_str(), data, size, 0) == 0;
+#endif
+}
+
+
+bool
+BPrivate::catalog_attributes_match(int fd, const char* name,
+	const char* mimeSignature, uint32_t fingerprint)
+{
+	char buffer[256];
+	ssize_t length = read_attribute(fd, kTypeAttribute, B_MIME_STRING_TYPE,
+		buffer, sizeof(buffer) - 1);
+	if (length > 0) {
+		buffer[length] = '\0';
+		if (strcmp(buffer, kCatalogMimeType) != 0)
+			return false;
+	}
+
+	// catcompile writes the signature of the catkeys file, which is a MIME
+	// type, and editors whatever create_catalog() was given, but catalogs
+	// are found by the name of the executable. MIME types are not case
+	// sensitive.
+	length = read_attribute(fd, kSignatureAttribute, B_STRING_TYPE, buffer,
+		sizeof(buffer) - 1);
+	if (length > 0) {
+		buffer[length] = '\0';
+		if (strcmp(buffer, name) != 0 && (mimeSignature == NULL
+				|| strcasecmp(buffer, mimeSignature) != 0))
+			return false;
+	}
+
+	if (fingerprint == 0)
+		return true;
+
+	uint32_t fileFingerprint;
+	length = read_attribute(fd, kFingerprintAttribute, B_UINT32_TYPE,
+		&fileFingerprint, sizeof(fileFingerprint));
+	return length != sizeof(fileFingerprint) || fileFingerprint == fingerprint;
+}
+
+
+bool
+BPrivate::write_catalog_attributes(int fd, const char* signature,
+	const char* language, uint32_t fingerprint)
+{
+	return write_attribute(fd, kTypeAttribute, B_MIME_STRING_TYPE,
+			kCatalogMimeType, strlen(kCatalogMimeType) + 1)
+		&& write_attribute(fd, kLanguageAttribute, B_STRING_TYPE, language,
+			strlen(language) + 1)
+		&& write_attribute(fd, kSignatureAttribute, B_STRING_TYPE, signature,
+			strlen(signature) + 1)
+		&& write_attribute(fd, kFingerprintAttribute, B_UINT32_TYPE,
+			&fingerprint, sizeof(fingerprint));
+}
@@ -0,0 +1,42 @@
+/*
+ * Copyright 2026, Adrien Destugues, pulkomandy@pulkomandy.tk.
+ * Distributed under the terms of the MIT License.
+ */
+#ifndef _CATALOG_ATTRIBUTES_H_
+#define _CATALOG_ATTRIBUTES_H_
+
+
+#include <stdint.h>
+
+
+namespace BPrivate {
+
+
+static const char* const kCatalogMimeType
+	= "locale/x-vnd.Be.locale-catalog.amiga";
+
+
+/*	The attributes the locale kit uses to describe catalog files, with the
+ *	same names and types as BLocaleRoster::kCat*Attr. On Haiku they are file
+ *	attributes. Elsewhere they are extended attributes in the user
+ *	namespace, so the tools can be used and tested on other systems.
+ */
+
+bool catalog_attributes_match(int fd, const char* name,
+	const char* mimeSignature, uint32_t fingerprint);
+	// False if the file has a type other than kCatalogMimeType, a
+	// signature which is neither the name of the executable nor its MIME
+	// signature (NULL if it has none), or, when fingerprint is not 0,
+	// another fingerprint. Missing attributes match, so files without any,
+	// like the ones copied from Amiga systems, always do. The language
+	// attribute holds whatever name the catalog was written with, an
+	// English or native name, or a code, so it can't tell that a catalog is
+	// for another language than its folder says.
+bool write_catalog_attributes(int fd, const char* signature,
+	const char* language, uint32_t fingerprint);
+
+
+} // namespace BPrivate
+
+
+#endif /* _CATALOG_ATTRIBUTES_H_ */
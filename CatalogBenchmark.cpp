@@ -0,0 +1,1577 @@
+/*
+ * Copyright 2026, Adrien Destugues, pulkomandy@pulkomandy.tk.
+ * Distributed under the terms of the MIT License.
+ */
+
+/*	Measures loading catalogs and looking strings up in them, in each of the
+ *	ways the add-on can load them, and prints the results as JSON so runs can
+ *	be compared with each other.
+ *
+ *	Each configuration runs in a process of its own, so the peak resident set
+ *	size it reports is its own. Allocations and read() calls are counted by
+ *	wrapping the C library functions, which only works with glibc. They are
+ *	reported as null elsewhere.
+ */
+
+
+#include <dirent.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <iconv.h>
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <sys/resource.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+
+#include <algorithm>
+#include <atomic>
+#include <map>
+#include <memory>
+#include <random>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "CatalogCache.h"
+#include "CatalogLoader.h"
+#include "CharsetConversion.h"
+#include "CTLGReader.h"
+#include "CTLGWriter.h"
+#include "MappedFile.h"
+#include "RandomCatalog.h"
+#include "StringTable.h"
+
+
+using BPrivate::CatalogCache;
+using BPrivate::code_set_decoder;
+using BPrivate::CTLGChunk;
+using BPrivate::CTLGChunkIterator;
+using BPrivate::CTLGString;
+using BPrivate::CTLGStringIterator;
+using BPrivate::ctlg_read_uint32;
+using BPrivate::CTLGWriter;
+using BPrivate::generate_random_catalog;
+using BPrivate::generate_random_strings;
+using BPrivate::IDStringTable;
+using BPrivate::is_valid_utf8;
+using BPrivate::kCTLGCodeSetLatin1;
+using BPrivate::kCTLGCodeSetUTF8;
+using BPrivate::kCTLGDefaultWindowSize;
+using BPrivate::latin1_to_utf8;
+using BPrivate::MappedFile;
+using BPrivate::RandomCatalogShape;
+using BPrivate::RandomString;
+using BPrivate::read_mapped_catalog;
+using BPrivate::read_streamed_catalog;
+
+
+#ifdef __GLIBC__
+#	define HAS_COUNTERS 1
+
+static std::atomic<uint64_t> sAllocations;
+static std::atomic<uint64_t> sAllocatedBytes;
+static std::atomic<uint64_t> sReads;
+
+extern "C" {
+
+void* __libc_malloc(size_t size);
+void* __libc_calloc(size_t count, size_t size);
+void* __libc_realloc(void* address, size_t size);
+ssize_t __read(int fd, void* buffer, size_t size);
+
+
+void*
+malloc(size_t size)
+{
+	sAllocations.fetch_add(1, std::memory_order_relaxed);
+	sAllocatedBytes.fetch_add(size, std::memory_order_relaxed);
+	return __libc_malloc(size);
+}
+
+
+void*
+calloc(size_t count, size_t size)
+{
+	sAllocations.fetch_add(1, std::memory_order_relaxed);
+	sAllocatedBytes.fetch_add(count * size, std::memory_order_relaxed);
+	return __libc_calloc(count, size);
+}
+
+
+void*
+realloc(void* address, size_t size)
+{
+	sAllocations.fetch_add(1, std::memory_order_relaxed);
+	sAllocatedBytes.fetch_add(size, std::memory_order_relaxed);
+	return __libc_realloc(address, size);
+}
+
+
+ssize_t
+read(int fd, void* buffer, size_t size)
+{
+	sReads.fetch_add(1, std::memory_order_relaxed);
+	return __read(fd, buffer, size);
+}
+
+}	// extern "C"
+
+#else
+#	define HAS_COUNTERS 0
+#endif
+
+
+struct Counters {
+	uint64_t	allocations;
+	uint64_t	allocatedBytes;
+	uint64_t	reads;
+};
+
+
+static void
+get_counters(Counters& counters)
+{
+#if HAS_COUNTERS
+	counters.allocations = sAllocations.load(std::memory_order_relaxed);
+	counters.allocatedBytes = sAllocatedBytes.load(std::memory_order_relaxed);
+	counters.reads = sReads.load(std::memory_order_relaxed);
+#else
+	memset(&counters, 0, sizeof(counters));
+#endif
+}
+
+
+static int64_t
+now()
+{
+	struct timespec time;
+	clock_gettime(CLOCK_MONOTONIC, &time);
+	return (int64_t)time.tv_sec * 1000000000 + time.tv_nsec;
+}
+
+
+static long
+peak_rss()
+{
+	// in KiB on Linux
+	struct rusage usage;
+	if (getrusage(RUSAGE_SELF, &usage) != 0)
+		return -1;
+	return usage.ru_maxrss;
+}
+
+
+struct Options {
+	int			repeats;
+	size_t		lookups;
+	size_t		threads;
+	size_t		windowSize;
+	size_t		parallelThreshold;
+	uint32_t	seed;
+};
+
+
+/*	One way of loading a catalog. Prepare() does what has to happen before
+ *	the first load and isn't measured, Load() replaces whatever the previous
+ *	load left.
+ */
+class Loader {
+	public:
+		virtual ~Loader() {}
+
+		virtual bool Prepare(const char* path) { return true; }
+		virtual bool Load(const char* path) = 0;
+		virtual const char* Lookup(uint32_t id) const = 0;
+		virtual void GetIDs(std::vector<uint32_t>& ids) const = 0;
+};
+
+
+class TableLoader : public Loader {
+	public:
+		const char* Lookup(uint32_t id) const
+		{
+			return fTable.Lookup(id);
+		}
+
+		void GetIDs(std::vector<uint32_t>& ids) const
+		{
+			ids.resize(fTable.CountItems());
+			for (size_t i = 0; i < ids.size(); i++)
+				ids[i] = fTable.IDAt(i);
+		}
+
+	protected:
+		IDStringTable	fTable;
+};
+
+
+class MappedLoader : public TableLoader {
+	public:
+		MappedLoader(bool lazy, size_t parallelThreshold)
+			:
+			fLazy(lazy),
+			fParallelThreshold(parallelThreshold)
+		{
+		}
+
+		bool Load(const char* path)
+		{
+			// Lazy tables keep using the file, which the add-on reads
+			// into memory for them
+			std::unique_ptr<MappedFile> source(new MappedFile(path,
+				fLazy ? MappedFile::kRead : MappedFile::kMapOnly));
+			if (source->InitCheck() != 0)
+				return false;
+
+			IDStringTable strings;
+			strings.SetParallelThreshold(fParallelThreshold);
+			std::string version, language;
+			if (read_mapped_catalog(source->Data(), source->Size(), strings,
+					fLazy, version, language) != 0
+				|| !strings.Finish())
+				return false;
+
+			fTable.Swap(strings);
+			// Lazy tables keep using the copy
+			fSource.reset(fLazy ? source.release() : NULL);
+			return true;
+		}
+
+	private:
+		bool						fLazy;
+		size_t						fParallelThreshold;
+		std::unique_ptr<MappedFile>	fSource;
+};
+
+
+class StreamedLoader : public TableLoader {
+	public:
+		StreamedLoader(size_t windowSize)
+			:
+			fWindowSize(windowSize)
+		{
+		}
+
+		bool Load(const char* path)
+		{
+			int fd = open(path, O_RDONLY);
+			if (fd < 0)
+				return false;
+
+			IDStringTable strings;
+			std::string version, language;
+			int error = read_streamed_catalog(fd, strings, version, language,
+				fWindowSize);
+			close(fd);
+			if (error != 0 || !strings.Finish())
+				return false;
+
+			fTable.Swap(strings);
+			return true;
+		}
+
+	private:
+		size_t	fWindowSize;
+};
+
+
+class CacheLoader : public TableLoader {
+	public:
+		CacheLoader(const std::string& directory)
+			:
+			fDirectory(directory)
+		{
+		}
+
+		bool Prepare(const char* path)
+		{
+			// The cache is keyed by the file as it was before reading it
+			struct stat st;
+			if (stat(path, &st) != 0)
+				return false;
+
+			IDStringTable strings;
+			MappedFile source(path);
+			std::string version, language;
+			if (source.InitCheck() != 0
+				|| read_mapped_catalog(source.Data(), source.Size(), strings,
+					false, version, language) != 0
+				|| !strings.Finish())
+				return false;
+
+			CatalogCache cache(fDirectory.c_str(), path);
+			return cache.Store(st, strings, version.c_str(), language.c_str(),
+				strings.Fingerprint());
+		}
+
+		bool Load(const char* path)
+		{
+			CatalogCache cache(fDirectory.c_str(), path);
+			IDStringTable strings;
+			std::string version, language;
+			uint32_t fingerprint;
+			MappedFile* image = cache.Load(strings, version, language,
+				fingerprint);
+			if (image == NULL)
+				return false;
+
+			fTable.Swap(strings);
+			// The table uses the cache file in place
+			fImage.reset(image);
+			return true;
+		}
+
+	private:
+		std::string					fDirectory;
+		std::unique_ptr<MappedFile>	fImage;
+};
+
+
+/*	Copies each string into a hash map, like HashMapCatalog does with a key
+ *	and a BString per entry, to compare lookups with the ID indexed table.
+ */
+class MapLoader : public Loader {
+	public:
+		const char* Lookup(uint32_t id) const
+		{
+			StringMap::const_iterator found = fStrings.find(id);
+			return found != fStrings.end() ? found->second.c_str() : NULL;
+		}
+
+		void GetIDs(std::vector<uint32_t>& ids) const
+		{
+			ids.clear();
+			ids.reserve(fStrings.size());
+			for (StringMap::const_iterator iterator = fStrings.begin();
+					iterator != fStrings.end(); iterator++)
+				ids.push_back(iterator->first);
+		}
+
+		bool Load(const char* path)
+		{
+			MappedFile source(path, MappedFile::kMapOnly);
+			if (source.InitCheck() != 0)
+				return false;
+
+			// The code set is needed before the first string
+			const IDStringTable::Decoder* decoder = code_set_decoder(0);
+			CTLGChunkIterator chunks(source.Data(), source.Size());
+			CTLGChunk chunk;
+			while (chunks.Next(chunk)) {
+				if (chunk.id == 'CSET' && chunk.size >= 4)
+					decoder = code_set_decoder(ctlg_read_uint32(chunk.data));
+			}
+			if (!chunks.IsValid())
+				return false;
+
+			StringMap strings;
+			std::vector<char> buffer;
+			chunks = CTLGChunkIterator(source.Data(), source.Size());
+			while (chunks.Next(chunk)) {
+				if (chunk.id != 'STRS')
+					continue;
+
+				CTLGStringIterator iterator(chunk);
+				CTLGString string;
+				while (iterator.Next(string)) {
+					buffer.resize(decoder->MaxDecodedLength(string.length) + 1);
+					size_t length = decoder->Decode(string.string,
+						string.length, &buffer[0]);
+					strings[string.id].assign(&buffer[0], length);
+				}
+				if (!iterator.IsValid())
+					return false;
+			}
+
+			fStrings.swap(strings);
+			return true;
+		}
+
+	protected:
+		typedef std::unordered_map<uint32_t, std::string> StringMap;
+
+		StringMap	fStrings;
+};
+
+
+/*	Reads the file the way the add-on did before it mapped catalogs: one
+ *	read() per header field, chunk ID and size, a copy of each chunk, and of
+ *	each string before converting it from ISO-8859-1 into the map.
+ */
+class FieldsLoader : public MapLoader {
+	public:
+		bool Load(const char* path)
+		{
+			int fd = open(path, O_RDONLY);
+			if (fd < 0)
+				return false;
+
+			bool success = _Read(fd);
+			close(fd);
+			return success;
+		}
+
+	private:
+		static bool _ReadUInt32(int fd, uint32_t& value)
+		{
+			uint8_t data[4];
+			if (read(fd, data, sizeof(data)) != sizeof(data))
+				return false;
+			value = ctlg_read_uint32(data);
+			return true;
+		}
+
+		bool _Read(int fd)
+		{
+			uint32_t type, dataSize;
+			if (!_ReadUInt32(fd, type) || type != 'FORM'
+				|| !_ReadUInt32(fd, dataSize)
+				|| !_ReadUInt32(fd, type) || type != 'CTLG' || dataSize < 4)
+				return false;
+			dataSize -= 4;
+
+			StringMap strings;
+			std::vector<char> value;
+			std::vector<char> converted;
+			while (dataSize >= 8) {
+				uint32_t chunkID, chunkSize;
+				if (!_ReadUInt32(fd, chunkID) || !_ReadUInt32(fd, chunkSize))
+					return false;
+				chunkSize += chunkSize & 1;
+				if (chunkSize > dataSize - 8)
+					return false;
+
+				std::vector<uint8_t> chunkData(chunkSize + 1);
+				if (read(fd, &chunkData[0], chunkSize) != (ssize_t)chunkSize)
+					return false;
+				dataSize -= chunkSize + 8;
+				if (chunkID != 'STRS')
+					continue;
+
+				size_t position = 0;
+				while (chunkSize - position >= 8) {
+					uint32_t id = ctlg_read_uint32(&chunkData[position]);
+					uint32_t length = ctlg_read_uint32(&chunkData[position + 4]);
+					position += 8;
+					length = (length + 3) & ~3;
+					if (length > chunkSize - position)
+						return false;
+
+					value.assign(&chunkData[position],
+						&chunkData[position] + length);
+					position += length;
+					size_t valueLength = strnlen(value.data(), length);
+					converted.resize(valueLength * 2 + 1);
+					strings[id].assign(&converted[0], latin1_to_utf8(
+						value.data(), valueLength, &converted[0]));
+				}
+			}
+
+			fStrings.swap(strings);
+			return true;
+		}
+};
+
+
+struct Configuration {
+	const char*	name;
+	const char*	description;
+};
+
+
+static const Configuration kConfigurations[] = {
+	{ "mapped", "mapped file, all strings decoded while loading" },
+	{ "lazy", "mapped file, strings decoded on first lookup" },
+	{ "streamed", "read through a fixed size window" },
+	{ "cache", "decoded catalog mapped from the cache" },
+	{ "map", "mapped file, strings copied into a hash map" },
+	{ "fields", "read field by field into a hash map, as before mapping" }
+};
+
+
+static Loader*
+create_loader(const char* name, const Options& options,
+	const std::string& cacheDirectory)
+{
+	if (strcmp(name, "mapped") == 0)
+		return new MappedLoader(false, options.parallelThreshold);
+	if (strcmp(name, "lazy") == 0)
+		return new MappedLoader(true, options.parallelThreshold);
+	if (strcmp(name, "streamed") == 0)
+		return new StreamedLoader(options.windowSize);
+	if (strcmp(name, "cache") == 0)
+		return new CacheLoader(cacheDirectory);
+	if (strcmp(name, "map") == 0)
+		return new MapLoader;
+	if (strcmp(name, "fields") == 0)
+		return new FieldsLoader;
+	return NULL;
+}
+
+
+/*!	Looks the IDs up from the given number of threads at once, each doing
+	\a lookups of them starting from a different place, and returns the
+	number of lookups per second of all of them together.
+*/
+static double
+measure_lookup_threads(const Loader& loader, const std::vector<uint32_t>& ids,
+	size_t threadCount, size_t lookups)
+{
+	if (ids.empty())
+		return 0;
+
+	std::atomic<bool> started(false);
+	std::vector<size_t> checksums(threadCount * 16);
+		// one cache line apart, so the threads don't share anything they
+		// write
+	std::vector<std::thread> threads;
+	for (size_t i = 0; i < threadCount; i++) {
+		threads.emplace_back([&, i]() {
+			size_t checksum = 0;
+			size_t index = ids.size() * i / threadCount;
+			while (!started.load(std::memory_order_acquire))
+				std::this_thread::yield();
+			for (size_t j = 0; j < lookups; j++) {
+				checksum += (uintptr_t)loader.Lookup(ids[index]);
+				if (++index == ids.size())
+					index = 0;
+			}
+			checksums[i * 16] = checksum;
+		});
+	}
+
+	int64_t start = now();
+	started.store(true, std::memory_order_release);
+	for (size_t i = 0; i < threadCount; i++)
+		threads[i].join();
+	int64_t elapsed = now() - start;
+
+	return elapsed > 0 ? threadCount * lookups * 1e9 / elapsed : 0.0;
+}
+
+
+/*!	Loads the catalog the given number of times, then looks up all of its
+	strings in a random order, and writes the results as a JSON object.
+	Returns false if something failed, the object then tells what.
+*/
+static bool
+run_configuration(const char* name, const char* path, const Options& options,
+	const std::string& cacheDirectory, FILE* output)
+{
+	long startRSS = peak_rss();
+
+	std::unique_ptr<Loader> loader(create_loader(name, options,
+		cacheDirectory));
+	if (!loader->Prepare(path)) {
+		fprintf(output, "{\"name\": \"%s\", \"error\": \"preparing failed\"}",
+			name);
+		return false;
+	}
+
+	std::vector<int64_t> times;
+	Counters before, after;
+	get_counters(before);
+	for (int i = 0; i < options.repeats; i++) {
+		int64_t start = now();
+		if (!loader->Load(path)) {
+			fprintf(output, "{\"name\": \"%s\", \"error\": \"loading failed\"}",
+				name);
+			return false;
+		}
+		times.push_back(now() - start);
+	}
+	get_counters(after);
+	std::sort(times.begin(), times.end());
+
+	std::vector<uint32_t> ids;
+	loader->GetIDs(ids);
+	std::shuffle(ids.begin(), ids.end(), std::mt19937(options.seed));
+
+	// The first pass decodes the strings of lazy tables, and all of them
+	// bring the strings in the cache.
+	size_t missing = 0;
+	int64_t start = now();
+	for (size_t i = 0; i < ids.size(); i++) {
+		if (loader->Lookup(ids[i]) == NULL)
+			missing++;
+	}
+	int64_t firstPass = now() - start;
+
+	// Strings cut short by a loader show up here
+	size_t stringBytes = 0;
+	size_t longestString = 0;
+	for (size_t i = 0; i < ids.size(); i++) {
+		const char* string = loader->Lookup(ids[i]);
+		size_t length = string != NULL ? strlen(string) : 0;
+		stringBytes += length;
+		longestString = std::max(longestString, length);
+	}
+
+	size_t lookups = 0;
+	size_t checksum = 0;
+	start = now();
+	while (lookups < options.lookups && !ids.empty()) {
+		for (size_t i = 0; i < ids.size() && lookups < options.lookups;
+				i++, lookups++)
+			checksum += (uintptr_t)loader->Lookup(ids[i]);
+	}
+	int64_t lookupTime = now() - start;
+
+	// Doubling the threads up to the maximum, which is measured too
+	std::vector<size_t> threadCounts;
+	for (size_t threads = 1; threads < options.threads; threads *= 2)
+		threadCounts.push_back(threads);
+	threadCounts.push_back(options.threads);
+
+	std::string scaling;
+	for (size_t i = 0; i < threadCounts.size(); i++) {
+		char entry[64];
+		snprintf(entry, sizeof(entry), "%s\"%zu\": %.0f",
+			i > 0 ? ", " : "", threadCounts[i],
+			measure_lookup_threads(*loader, ids, threadCounts[i],
+				options.lookups));
+		scaling += entry;
+	}
+
+	fprintf(output, "{\"name\": \"%s\", ", name);
+	fprintf(output, "\"loadNanoseconds\": {\"min\": %lld, \"median\": %lld, "
+		"\"max\": %lld}, ", (long long)times.front(),
+		(long long)times[times.size() / 2], (long long)times.back());
+	if (HAS_COUNTERS) {
+		fprintf(output, "\"allocationsPerLoad\": %llu, "
+			"\"allocatedBytesPerLoad\": %llu, \"readsPerLoad\": %llu, ",
+			(unsigned long long)(after.allocations - before.allocations)
+				/ options.repeats,
+			(unsigned long long)(after.allocatedBytes - before.allocatedBytes)
+				/ options.repeats,
+			(unsigned long long)(after.reads - before.reads)
+				/ options.repeats);
+	} else {
+		fprintf(output, "\"allocationsPerLoad\": null, "
+			"\"allocatedBytesPerLoad\": null, \"readsPerLoad\": null, ");
+	}
+	fprintf(output, "\"strings\": %zu, \"missing\": %zu, "
+		"\"stringBytes\": %zu, \"longestString\": %zu, "
+		"\"firstLookupPassNanoseconds\": %lld, \"lookupsPerSecond\": %.0f, "
+		"\"lookupsPerSecondByThreads\": {%s}, "
+		"\"startRSSKiB\": %ld, \"peakRSSKiB\": %ld, \"checksum\": %zu}",
+		ids.size(), missing, stringBytes, longestString, (long long)firstPass,
+		lookupTime > 0 ? lookups * 1e9 / lookupTime : 0.0, scaling.c_str(),
+		startRSS, peak_rss(), checksum & 0xffff);
+	return missing == 0;
+}
+
+
+/*!	Runs a configuration in a child process and appends its JSON object to
+	\a results.
+*/
+static bool
+run_in_child(const char* name, const char* path, const Options& options,
+	const std::string& cacheDirectory, std::string& results)
+{
+	int pipeFDs[2];
+	if (pipe(pipeFDs) != 0)
+		return false;
+
+	fflush(NULL);
+	pid_t child = fork();
+	if (child < 0) {
+		close(pipeFDs[0]);
+		close(pipeFDs[1]);
+		return false;
+	}
+	if (child == 0) {
+		close(pipeFDs[0]);
+		FILE* output = fdopen(pipeFDs[1], "w");
+		bool success = output != NULL
+			&& run_configuration(name, path, options, cacheDirectory, output);
+		if (output != NULL)
+			fclose(output);
+		_exit(success ? 0 : 1);
+	}
+
+	close(pipeFDs[1]);
+	std::string object;
+	char buffer[4096];
+	ssize_t bytesRead;
+	while ((bytesRead = read(pipeFDs[0], buffer, sizeof(buffer))) > 0)
+		object.append(buffer, bytesRead);
+	close(pipeFDs[0]);
+
+	int status;
+	waitpid(child, &status, 0);
+	if (object.empty()) {
+		object = std::string("{\"name\": \"") + name
+			+ "\", \"error\": \"crashed\"}";
+	}
+	results += object;
+	return WIFEXITED(status) && WEXITSTATUS(status) == 0;
+}
+
+
+/*	Strings as found in translated catalogs, to measure the conversion
+ *	kernels on text with as many non-ASCII characters as real ones. They are
+ *	stored in the 8-bit code set such catalogs use.
+ */
+static const char* const kEnglishStrings[] = {
+	"Open", "Save as…", "Close window", "Quit",
+	"Are you sure you want to delete this file?",
+	"The document could not be saved because the disk is full.",
+	"Preferences", "Show hidden files", "Sort by modification date",
+	"%d files selected", "Cancel", "Move to Trash",
+	"This operation cannot be undone. Do you want to continue anyway?"
+};
+
+static const char* const kGermanStrings[] = {
+	"Öffnen", "Speichern unter…", "Fenster schließen", "Beenden",
+	"Möchten Sie diese Datei wirklich löschen?",
+	"Das Dokument konnte nicht gespeichert werden, weil der Datenträger "
+		"voll ist.",
+	"Einstellungen", "Versteckte Dateien anzeigen",
+	"Nach Änderungsdatum sortieren", "%d Dateien ausgewählt", "Abbrechen",
+	"In den Papierkorb verschieben",
+	"Dieser Vorgang kann nicht rückgängig gemacht werden. Trotzdem "
+		"fortfahren?"
+};
+
+static const char* const kFrenchStrings[] = {
+	"Ouvrir", "Enregistrer sous…", "Fermer la fenêtre", "Quitter",
+	"Êtes-vous sûr de vouloir supprimer ce fichier ?",
+	"Le document n'a pas pu être enregistré car le disque est plein.",
+	"Préférences", "Afficher les fichiers cachés",
+	"Trier par date de modification", "%d fichiers sélectionnés", "Annuler",
+	"Déplacer vers la corbeille",
+	"Cette opération est irréversible. Voulez-vous quand même continuer ?"
+};
+
+static const char* const kPolishStrings[] = {
+	"Otwórz", "Zapisz jako…", "Zamknij okno", "Zakończ",
+	"Czy na pewno chcesz usunąć ten plik?",
+	"Nie można zapisać dokumentu, ponieważ dysk jest pełny.",
+	"Ustawienia", "Pokaż ukryte pliki", "Sortuj według daty modyfikacji",
+	"Zaznaczono plików: %d", "Anuluj", "Przenieś do kosza",
+	"Tej operacji nie można cofnąć. Czy mimo to chcesz kontynuować?"
+};
+
+static const char* const kCzechStrings[] = {
+	"Otevřít", "Uložit jako…", "Zavřít okno", "Ukončit",
+	"Opravdu chcete smazat tento soubor?",
+	"Dokument nelze uložit, protože disk je plný.",
+	"Nastavení", "Zobrazit skryté soubory", "Řadit podle data změny",
+	"Vybráno souborů: %d", "Zrušit", "Přesunout do koše",
+	"Tuto operaci nelze vrátit zpět. Přesto pokračovat?"
+};
+
+static const char* const kRussianStrings[] = {
+	"Открыть", "Сохранить как…", "Закрыть окно", "Выход",
+	"Вы действительно хотите удалить этот файл?",
+	"Не удалось сохранить документ, потому что диск заполнен.",
+	"Настройки", "Показывать скрытые файлы", "Сортировать по дате изменения",
+	"Выбрано файлов: %d", "Отмена", "Переместить в корзину",
+	"Эту операцию нельзя отменить. Всё равно продолжить?"
+};
+
+static const char* const kGreekStrings[] = {
+	"Άνοιγμα", "Αποθήκευση ως…", "Κλείσιμο παραθύρου", "Έξοδος",
+	"Θέλετε σίγουρα να διαγράψετε αυτό το αρχείο;",
+	"Δεν ήταν δυνατή η αποθήκευση του εγγράφου, επειδή ο δίσκος είναι "
+		"γεμάτος.",
+	"Προτιμήσεις", "Εμφάνιση κρυφών αρχείων",
+	"Ταξινόμηση κατά ημερομηνία τροποποίησης", "Επιλεγμένα αρχεία: %d",
+	"Ακύρωση", "Μετακίνηση στα απορρίμματα",
+	"Αυτή η ενέργεια δεν μπορεί να αναιρεθεί. Συνέχεια;"
+};
+
+static const char* const kTurkishStrings[] = {
+	"Aç", "Farklı kaydet…", "Pencereyi kapat", "Çık",
+	"Bu dosyayı silmek istediğinizden emin misiniz?",
+	"Disk dolu olduğu için belge kaydedilemedi.",
+	"Tercihler", "Gizli dosyaları göster", "Değiştirilme tarihine göre sırala",
+	"%d dosya seçildi", "İptal", "Çöp kutusuna taşı",
+	"Bu işlem geri alınamaz. Yine de devam edilsin mi?"
+};
+
+
+struct Text {
+	const char*			name;
+	const char* const*	strings;
+	size_t				count;
+	uint32_t			codeSet;
+	const char*			charset;
+		// the name iconv knows the code set by
+};
+
+
+#define TEXT(name, strings, codeSet, charset) \
+	{ name, strings, sizeof(strings) / sizeof(strings[0]), codeSet, charset }
+
+static const Text kTexts[] = {
+	TEXT("english", kEnglishStrings, kCTLGCodeSetLatin1, "ISO-8859-1"),
+	TEXT("german", kGermanStrings, kCTLGCodeSetLatin1, "ISO-8859-1"),
+	TEXT("french", kFrenchStrings, kCTLGCodeSetLatin1, "ISO-8859-1"),
+	TEXT("polish", kPolishStrings, 5, "ISO-8859-2")
+};
+
+// Each language in the code pages catalogs for it are found in, by MIBenum
+static const Text kCodePageTexts[] = {
+	TEXT("polish", kPolishStrings, 5, "ISO-8859-2"),
+	TEXT("polish", kPolishStrings, 2250, "WINDOWS-1250"),
+	TEXT("czech", kCzechStrings, 5, "ISO-8859-2"),
+	TEXT("czech", kCzechStrings, 2250, "WINDOWS-1250"),
+	TEXT("russian", kRussianStrings, 8, "ISO-8859-5"),
+	TEXT("russian", kRussianStrings, 2084, "KOI8-R"),
+	TEXT("russian", kRussianStrings, 2251, "WINDOWS-1251"),
+	TEXT("greek", kGreekStrings, 10, "ISO-8859-7"),
+	TEXT("greek", kGreekStrings, 2253, "WINDOWS-1253"),
+	TEXT("turkish", kTurkishStrings, 12, "ISO-8859-9"),
+	TEXT("german", kGermanStrings, 111, "ISO-8859-15"),
+	TEXT("german", kGermanStrings, 2252, "WINDOWS-1252")
+};
+
+#undef TEXT
+
+
+/*!	Converts the UTF-8 strings of the text to another code set, using its
+	decoder backwards. Characters it doesn't have become question marks.
+*/
+static void
+encode_text(const Text& text, uint32_t codeSet,
+	std::vector<std::string>& strings)
+{
+	strings.assign(text.strings, text.strings + text.count);
+	if (codeSet == kCTLGCodeSetUTF8)
+		return;
+
+	const IDStringTable::Decoder* decoder = code_set_decoder(codeSet);
+	std::map<std::string, char> characters;
+	for (int c = 0; c < 256; c++) {
+		char source = (char)c;
+		char decoded[8];
+		size_t length = decoder->Decode(&source, 1, decoded);
+		characters.insert(std::make_pair(std::string(decoded, length),
+			source));
+	}
+
+	for (size_t i = 0; i < strings.size(); i++) {
+		const char* string = text.strings[i];
+		std::string encoded;
+		while (*string != '\0') {
+			size_t length = 1;
+			while ((string[length] & 0xc0) == 0x80)
+				length++;
+
+			std::map<std::string, char>::const_iterator found
+				= characters.find(std::string(string, length));
+			encoded += found != characters.end() ? found->second : '?';
+			string += length;
+		}
+		strings[i] = encoded;
+	}
+}
+
+
+/*!	The conversion as the add-on did it before it had kernels, one byte
+	at a time.
+*/
+static size_t
+bytewise_latin1_to_utf8(const char* source, size_t length, char* target)
+{
+	char* start = target;
+	for (size_t i = 0; i < length; i++) {
+		uint8_t c = source[i];
+		if (c < 0x80)
+			*target++ = c;
+		else {
+			*target++ = 0xc0 | (c >> 6);
+			*target++ = 0x80 | (c & 0x3f);
+		}
+	}
+	return target - start;
+}
+
+
+/*!	Runs a kernel on each string of the text in turn, for at least a tenth
+	of a second, and writes its throughput as a JSON object. The best of three
+	runs is kept. The kernel is called like latin1_to_utf8().
+*/
+template<typename Kernel>
+static void
+run_kernel(const char* name, const char* implementation, Kernel kernel,
+	const Text& text, uint32_t codeSet, const std::vector<std::string>& strings,
+	std::string& results)
+{
+	size_t bytes = 0;
+	size_t nonASCII = 0;
+	size_t maxLength = 0;
+	for (size_t i = 0; i < strings.size(); i++) {
+		bytes += strings[i].size();
+		maxLength = std::max(maxLength, strings[i].size());
+		for (size_t j = 0; j < strings[i].size(); j++)
+			nonASCII += (uint8_t)strings[i][j] >= 0x80;
+	}
+	std::vector<char> target(maxLength * 4 + 1);
+
+	double best = 0;
+	size_t checksum = 0;
+	for (int run = 0; run < 3; run++) {
+		size_t processed = 0;
+		int64_t start = now();
+		int64_t elapsed;
+		do {
+			for (int pass = 0; pass < 100; pass++) {
+				for (size_t i = 0; i < strings.size(); i++) {
+					checksum += kernel(strings[i].data(), strings[i].size(),
+						&target[0]);
+				}
+				processed += bytes;
+			}
+			elapsed = now() - start;
+		} while (elapsed < 100000000);
+
+		best = std::max(best, processed * 1e3 / elapsed);
+	}
+
+	char object[512];
+	snprintf(object, sizeof(object), "{\"kernel\": \"%s\", "
+		"\"implementation\": \"%s\", \"text\": \"%s\", \"codeSet\": %u, "
+		"\"bytes\": %zu, \"nonASCIIPercent\": %.1f, "
+		"\"megabytesPerSecond\": %.1f, \"checksum\": %zu}", name,
+		implementation, text.name, codeSet, bytes,
+		bytes > 0 ? nonASCII * 100.0 / bytes : 0.0, best, checksum & 0xffff);
+	if (!results.empty())
+		results += ",\n\t\t";
+	results += object;
+}
+
+
+struct DecoderKernel {
+	DecoderKernel(const IDStringTable::Decoder* decoder)
+		:
+		fDecoder(decoder)
+	{
+	}
+
+	size_t operator()(const char* source, size_t length, char* target) const
+	{
+		return fDecoder->Decode(source, length, target);
+	}
+
+	const IDStringTable::Decoder*	fDecoder;
+};
+
+
+struct IconvKernel {
+	IconvKernel(const char* charset)
+		:
+		fCharset(charset)
+	{
+	}
+
+	size_t operator()(const char* source, size_t length, char* target) const
+	{
+		iconv_t converter = iconv_open("UTF-8", fCharset);
+		if (converter == (iconv_t)-1)
+			return 0;
+
+		char* in = const_cast<char*>(source);
+		char* out = target;
+		size_t outLeft = length * 3;
+		iconv(converter, &in, &length, &out, &outLeft);
+		iconv_close(converter);
+		return out - target;
+	}
+
+	const char*	fCharset;
+};
+
+
+static void
+run_kernels(std::string& results)
+{
+	const IDStringTable::Decoder* defaultDecoder = code_set_decoder(0);
+	const IDStringTable::Decoder* utf8Decoder
+		= code_set_decoder(kCTLGCodeSetUTF8);
+
+	for (size_t i = 0; i < sizeof(kTexts) / sizeof(kTexts[0]); i++) {
+		const Text& text = kTexts[i];
+		std::vector<std::string> strings;
+		std::vector<std::string> utf8Strings;
+		encode_text(text, text.codeSet, strings);
+		encode_text(text, kCTLGCodeSetUTF8, utf8Strings);
+
+		// The kernel doesn't care which code set the bytes are in
+		run_kernel("latin1_to_utf8", "library", latin1_to_utf8, text,
+			text.codeSet, strings, results);
+		run_kernel("latin1_to_utf8", "bytewise", bytewise_latin1_to_utf8,
+			text, text.codeSet, strings, results);
+
+		// Catalogs that don't tell their code set are checked for UTF-8
+		// first, which should cost little compared to converting them.
+		auto validate = [](const char* source, size_t length, char*) {
+			return (size_t)is_valid_utf8(source, length);
+		};
+		run_kernel("is_valid_utf8", "library", validate, text,
+			kCTLGCodeSetUTF8, utf8Strings, results);
+		run_kernel("is_valid_utf8", "library", validate, text, text.codeSet,
+			strings, results);
+
+		run_kernel("decoder", "default", DecoderKernel(defaultDecoder), text,
+			kCTLGCodeSetUTF8, utf8Strings, results);
+		run_kernel("decoder", "default", DecoderKernel(defaultDecoder), text,
+			text.codeSet, strings, results);
+		run_kernel("decoder", "code set", DecoderKernel(utf8Decoder), text,
+			kCTLGCodeSetUTF8, utf8Strings, results);
+		run_kernel("decoder", "code set",
+			DecoderKernel(code_set_decoder(text.codeSet)), text, text.codeSet,
+			strings, results);
+	}
+
+	// The code page tables against a converter set up for each string, as
+	// convert_to_utf8() does
+	for (size_t i = 0; i < sizeof(kCodePageTexts) / sizeof(kCodePageTexts[0]);
+			i++) {
+		const Text& text = kCodePageTexts[i];
+		std::vector<std::string> strings;
+		encode_text(text, text.codeSet, strings);
+
+		run_kernel("decoder", "code set",
+			DecoderKernel(code_set_decoder(text.codeSet)), text, text.codeSet,
+			strings, results);
+		run_kernel("decoder", "iconv", IconvKernel(text.charset), text,
+			text.codeSet, strings, results);
+	}
+}
+
+
+/*!	Makes \a count IDs laid out in one of the ways catalogs use them:
+	consecutive, in blocks of 20 per thousand as when each module of an
+	application gets its own range, or spread over the whole 32 bit range.
+*/
+static void
+make_ids(const char* layout, size_t count, uint32_t seed,
+	std::vector<uint32_t>& ids)
+{
+	ids.clear();
+	if (strcmp(layout, "dense") == 0) {
+		for (size_t i = 0; i < count; i++)
+			ids.push_back(i + 1);
+	} else if (strcmp(layout, "blocks") == 0) {
+		for (size_t i = 0; i < count; i++)
+			ids.push_back((i / 20 + 1) * 1000 + i % 20);
+	} else {
+		std::mt19937 random(seed);
+		std::unordered_set<uint32_t> used;
+		while (ids.size() < count) {
+			uint32_t id = random();
+			if (used.insert(id).second)
+				ids.push_back(id);
+		}
+	}
+}
+
+
+/*!	Builds the ID indexed table or a hash map from the same strings, the
+	given number of times, then looks them up in a random order, and writes
+	the build time and lookup throughput as a JSON object.
+*/
+static void
+run_index(const char* index, const char* layout,
+	const std::vector<uint32_t>& ids, const std::vector<std::string>& strings,
+	const Options& options, std::string& results)
+{
+	bool isTable = strcmp(index, "table") == 0;
+	size_t stringsSize = 0;
+	for (size_t i = 0; i < strings.size(); i++)
+		stringsSize += strings[i].size() + 1;
+
+	IDStringTable table;
+	std::unordered_map<uint32_t, std::string> map;
+	std::vector<int64_t> times;
+	for (int run = 0; run < options.repeats; run++) {
+		int64_t start = now();
+		if (isTable) {
+			IDStringTable built;
+			built.Reserve(stringsSize);
+			for (size_t i = 0; i < ids.size(); i++)
+				built.Add(ids[i], strings[i].data(), strings[i].size());
+			built.Finish();
+			times.push_back(now() - start);
+			table.Swap(built);
+		} else {
+			std::unordered_map<uint32_t, std::string> built;
+			for (size_t i = 0; i < ids.size(); i++)
+				built[ids[i]] = strings[i];
+			times.push_back(now() - start);
+			map.swap(built);
+		}
+	}
+	std::sort(times.begin(), times.end());
+
+	std::vector<uint32_t> order = ids;
+	std::shuffle(order.begin(), order.end(), std::mt19937(options.seed));
+
+	size_t lookups = 0;
+	size_t checksum = 0;
+	int64_t start = now();
+	while (lookups < options.lookups && !order.empty()) {
+		for (size_t i = 0; i < order.size() && lookups < options.lookups;
+				i++, lookups++) {
+			if (isTable)
+				checksum += (uintptr_t)table.Lookup(order[i]);
+			else {
+				std::unordered_map<uint32_t, std::string>::const_iterator
+					found = map.find(order[i]);
+				if (found != map.end())
+					checksum += (uintptr_t)found->second.c_str();
+			}
+		}
+	}
+	int64_t lookupTime = now() - start;
+
+	char object[512];
+	snprintf(object, sizeof(object), "{\"index\": \"%s\", "
+		"\"layout\": \"%s\", \"ids\": %zu, \"buildNanoseconds\": "
+		"{\"min\": %lld, \"median\": %lld, \"max\": %lld}, "
+		"\"lookupsPerSecond\": %.0f, \"checksum\": %zu}", index, layout,
+		ids.size(), (long long)times.front(),
+		(long long)times[times.size() / 2], (long long)times.back(),
+		lookupTime > 0 ? lookups * 1e9 / lookupTime : 0.0, checksum & 0xffff);
+	if (!results.empty())
+		results += ",\n\t\t";
+	results += object;
+}
+
+
+static void
+run_indexes(const Options& options, std::string& results)
+{
+	const char* const kLayouts[] = { "dense", "blocks", "random" };
+	const size_t kCounts[] = { 1000, 10000, 100000 };
+
+	for (size_t i = 0; i < sizeof(kLayouts) / sizeof(kLayouts[0]); i++) {
+		for (size_t j = 0; j < sizeof(kCounts) / sizeof(kCounts[0]); j++) {
+			std::vector<uint32_t> ids;
+			make_ids(kLayouts[i], kCounts[j], options.seed, ids);
+
+			std::vector<std::string> strings;
+			for (size_t k = 0; k < ids.size(); k++) {
+				char string[32];
+				snprintf(string, sizeof(string), "String %" PRIu32, ids[k]);
+				strings.push_back(string);
+			}
+
+			run_index("table", kLayouts[i], ids, strings, options, results);
+			run_index("map", kLayouts[i], ids, strings, options, results);
+		}
+	}
+}
+
+
+/*!	Writes a catalog of random strings the way the add-on writes catalogs
+	for editors: the strings are added to a CTLGWriter, flattened, and the
+	buffer is written with a single call. Flattening and writing are timed
+	separately, and written as a JSON object.
+*/
+static bool
+run_write(const char* strings, size_t count, const Options& options,
+	const std::string& path, std::string& results)
+{
+	// ASCII strings are stored as ISO-8859-1, the others make the whole
+	// catalog UTF-8
+	RandomCatalogShape shape;
+	shape.count = count;
+	shape.seed = options.seed;
+	if (strcmp(strings, "ascii") == 0)
+		shape.nonASCIIPercent = 0;
+
+	std::vector<RandomString> randomStrings;
+	if (generate_random_strings(shape, randomStrings) != 0)
+		return false;
+
+	std::vector<int64_t> flattenTimes;
+	std::vector<int64_t> writeTimes;
+	size_t size = 0;
+	for (int run = 0; run < options.repeats; run++) {
+		int64_t start = now();
+		CTLGWriter writer("x-vnd.Amiga-GeneratedCatalog", "english");
+		for (size_t i = 0; i < randomStrings.size(); i++) {
+			if (!writer.AddString(randomStrings[i].id,
+					randomStrings[i].string.c_str(),
+					randomStrings[i].string.size()))
+				return false;
+		}
+		std::vector<uint8_t> buffer;
+		if (!writer.Flatten(buffer))
+			return false;
+		int64_t flattened = now();
+
+		int fd = open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+		if (fd < 0)
+			return false;
+		ssize_t written = write(fd, &buffer[0], buffer.size());
+		close(fd);
+		if (written != (ssize_t)buffer.size())
+			return false;
+
+		flattenTimes.push_back(flattened - start);
+		writeTimes.push_back(now() - flattened);
+		size = buffer.size();
+	}
+	std::sort(flattenTimes.begin(), flattenTimes.end());
+	std::sort(writeTimes.begin(), writeTimes.end());
+
+	char object[512];
+	snprintf(object, sizeof(object), "{\"strings\": \"%s\", "
+		"\"count\": %zu, \"size\": %zu, \"flattenNanoseconds\": "
+		"{\"min\": %lld, \"median\": %lld, \"max\": %lld}, "
+		"\"writeNanoseconds\": {\"min\": %lld, \"median\": %lld, "
+		"\"max\": %lld}}", strings, count, size,
+		(long long)flattenTimes.front(),
+		(long long)flattenTimes[flattenTimes.size() / 2],
+		(long long)flattenTimes.back(), (long long)writeTimes.front(),
+		(long long)writeTimes[writeTimes.size() / 2],
+		(long long)writeTimes.back());
+	if (!results.empty())
+		results += ",\n\t\t";
+	results += object;
+	return true;
+}
+
+
+static bool
+run_writes(const Options& options, const std::string& directory,
+	std::string& results)
+{
+	const char* const kStrings[] = { "ascii", "utf8" };
+	const size_t kCounts[] = { 1000, 10000, 100000 };
+
+	std::string path = directory + "/written.catalog";
+	for (size_t i = 0; i < sizeof(kStrings) / sizeof(kStrings[0]); i++) {
+		for (size_t j = 0; j < sizeof(kCounts) / sizeof(kCounts[0]); j++) {
+			if (!run_write(kStrings[i], kCounts[j], options, path, results))
+				return false;
+		}
+	}
+	return true;
+}
+
+
+/*!	Writes the catalog from a child process, so the memory it takes doesn't
+	count in the resident set size of the configurations.
+*/
+static bool
+generate_catalog_file(const RandomCatalogShape& shape, const char* path)
+{
+	fflush(NULL);
+	pid_t child = fork();
+	if (child < 0)
+		return false;
+	if (child == 0) {
+		std::vector<uint8_t> buffer;
+		uint32_t fingerprint;
+		if (generate_random_catalog(shape, "x-vnd.Amiga-GeneratedCatalog",
+				"english", buffer, fingerprint) != 0)
+			_exit(1);
+
+		int fd = open(path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+		if (fd < 0)
+			_exit(1);
+		ssize_t written = write(fd, &buffer[0], buffer.size());
+		close(fd);
+		_exit(written == (ssize_t)buffer.size() ? 0 : 1);
+	}
+
+	int status;
+	return waitpid(child, &status, 0) == child && WIFEXITED(status)
+		&& WEXITSTATUS(status) == 0;
+}
+
+
+static std::string
+json_string(const char* string)
+{
+	std::string quoted = "\"";
+	for (const char* c = string; *c != '\0'; c++) {
+		if (*c == '"' || *c == '\\')
+			quoted += '\\';
+		if ((uint8_t)*c < 0x20) {
+			char escaped[8];
+			snprintf(escaped, sizeof(escaped), "\\u%04x", *c);
+			quoted += escaped;
+		} else
+			quoted += *c;
+	}
+	return quoted + "\"";
+}
+
+
+static void
+remove_directory(const std::string& path)
+{
+	DIR* dir = opendir(path.c_str());
+	if (dir != NULL) {
+		while (struct dirent* entry = readdir(dir)) {
+			if (strcmp(entry->d_name, ".") == 0
+				|| strcmp(entry->d_name, "..") == 0)
+				continue;
+
+			std::string entryPath = path + "/" + entry->d_name;
+			struct stat st;
+			if (lstat(entryPath.c_str(), &st) == 0 && S_ISDIR(st.st_mode))
+				remove_directory(entryPath);
+			else
+				unlink(entryPath.c_str());
+		}
+		closedir(dir);
+	}
+	rmdir(path.c_str());
+}
+
+
+static void
+usage()
+{
+	fprintf(stderr, "usage: catbench [-n <strings>] [-d <density>] "
+		"[-l <min>[-<max>]] [-c <code set>]\n"
+		"\t[-x <non-ASCII percent>] [-s <seed>] [-r <repeats>] "
+		"[-k <lookups>]\n"
+		"\t[-t <threads>] [-w <window size>] [-p <parallel threshold>]\n"
+		"\t[-C <configuration>[,...]] [<catalog>]\n"
+		"       catbench -K\n"
+		"       catbench -I [-r <repeats>] [-k <lookups>] [-s <seed>]\n"
+		"       catbench -W [-r <repeats>] [-s <seed>]\n\n"
+		"Without a catalog, one is generated like catgenerate does.\n"
+		"With -K, the conversion kernels are measured instead, with -I the\n"
+		"index of the string table against a hash map, with -W writing\n"
+		"catalogs.\n"
+		"Configurations:\n");
+	for (size_t i = 0; i < sizeof(kConfigurations) / sizeof(kConfigurations[0]);
+			i++) {
+		fprintf(stderr, "\t%-10s%s\n", kConfigurations[i].name,
+			kConfigurations[i].description);
+	}
+	exit(1);
+}
+
+
+static unsigned long
+parse_number(const char* string)
+{
+	char* end;
+	unsigned long value = strtoul(string, &end, 10);
+	if (end == string || *end != '\0')
+		usage();
+	return value;
+}
+
+
+int
+main(int argc, char** argv)
+{
+	RandomCatalogShape shape;
+	Options options;
+	options.repeats = 10;
+	options.lookups = 10000000;
+	options.threads = std::max(std::thread::hardware_concurrency(), 1u);
+	options.windowSize = kCTLGDefaultWindowSize;
+	options.parallelThreshold = 16384;
+		// as in the add-on
+	std::vector<std::string> configurations;
+	bool kernels = false;
+	bool indexes = false;
+	bool writes = false;
+
+	int option;
+	while ((option = getopt(argc, argv, "n:d:l:c:x:s:r:k:t:w:p:C:KIW"))
+			!= -1) {
+		switch (option) {
+			case 'n':
+				shape.count = parse_number(optarg);
+				break;
+			case 'd':
+			{
+				char* end;
+				shape.density = strtod(optarg, &end);
+				if (end == optarg || *end != '\0' || shape.density <= 0
+					|| shape.density > 1)
+					usage();
+				break;
+			}
+			case 'l':
+			{
+				std::string lengths = optarg;
+				size_t dash = lengths.find('-');
+				shape.minLength = shape.maxLength = parse_number(
+					lengths.substr(0, dash).c_str());
+				if (dash != std::string::npos)
+					shape.maxLength = parse_number(lengths.c_str() + dash + 1);
+				if (shape.maxLength < shape.minLength)
+					usage();
+				break;
+			}
+			case 'c':
+			{
+				unsigned long codeSet = parse_number(optarg);
+				if (codeSet == 0 || codeSet > UINT32_MAX)
+					usage();
+				shape.codeSet = codeSet;
+				break;
+			}
+			case 'x':
+				shape.nonASCIIPercent = parse_number(optarg);
+				if (shape.nonASCIIPercent > 100)
+					usage();
+				break;
+			case 's':
+				shape.seed = parse_number(optarg);
+				break;
+			case 'r':
+				options.repeats = parse_number(optarg);
+				if (options.repeats <= 0)
+					usage();
+				break;
+			case 'k':
+				options.lookups = parse_number(optarg);
+				break;
+			case 't':
+				options.threads = parse_number(optarg);
+				if (options.threads == 0)
+					usage();
+				break;
+			case 'w':
+				options.windowSize = parse_number(optarg);
+				break;
+			case 'p':
+				options.parallelThreshold = parse_number(optarg);
+				break;
+			case 'C':
+			{
+				std::string list = optarg;
+				size_t start = 0;
+				while (start <= list.size()) {
+					size_t comma = list.find(',', start);
+					if (comma == std::string::npos)
+						comma = list.size();
+					configurations.push_back(
+						list.substr(start, comma - start));
+					start = comma + 1;
+				}
+				break;
+			}
+			case 'K':
+				kernels = true;
+				break;
+			case 'I':
+				indexes = true;
+				break;
+			case 'W':
+				writes = true;
+				break;
+			default:
+				usage();
+		}
+	}
+	if (argc - optind > 1)
+		usage();
+	options.seed = shape.seed;
+
+	if (kernels) {
+		std::string results;
+		run_kernels(results);
+		printf("{\n\t\"kernels\": [\n\t\t%s\n\t]\n}\n", results.c_str());
+		return 0;
+	}
+	if (indexes) {
+		std::string results;
+		run_indexes(options, results);
+		printf("{\n\t\"indexes\": [\n\t\t%s\n\t]\n}\n", results.c_str());
+		return 0;
+	}
+
+	if (configurations.empty()) {
+		for (size_t i = 0;
+				i < sizeof(kConfigurations) / sizeof(kConfigurations[0]); i++)
+			configurations.push_back(kConfigurations[i].name);
+	}
+	for (size_t i = 0; i < configurations.size(); i++) {
+		Loader* loader = create_loader(configurations[i].c_str(), options, "");
+		if (loader == NULL)
+			usage();
+		delete loader;
+	}
+
+	char temporary[] = "/tmp/catbench.XXXXXX";
+	if (mkdtemp(temporary) == NULL) {
+		fprintf(stderr, "catbench: could not create a temporary folder: %s\n",
+			strerror(errno));
+		return 1;
+	}
+	std::string directory = temporary;
+	std::string cacheDirectory = directory + "/cache";
+
+	if (writes) {
+		std::string results;
+		bool success = run_writes(options, directory, results);
+		if (!success)
+			fprintf(stderr, "catbench: could not write the catalogs\n");
+		printf("{\n\t\"repeats\": %d,\n\t\"writes\": [\n\t\t%s\n\t]\n}\n",
+			options.repeats, results.c_str());
+		remove_directory(directory);
+		return success ? 0 : 1;
+	}
+
+	std::string path;
+	bool generated = optind == argc;
+	if (generated) {
+		path = directory + "/generated.catalog";
+
+		if (!generate_catalog_file(shape, path.c_str())) {
+			fprintf(stderr, "catbench: could not generate the catalog\n");
+			remove_directory(directory);
+			return 1;
+		}
+	} else
+		path = argv[optind];
+
+	struct stat st;
+	if (stat(path.c_str(), &st) != 0) {
+		fprintf(stderr, "catbench: %s: %s\n", path.c_str(), strerror(errno));
+		remove_directory(directory);
+		return 1;
+	}
+
+	std::string results;
+	bool success = true;
+	for (size_t i = 0; i < configurations.size(); i++) {
+		if (i > 0)
+			results += ",\n\t\t";
+		if (!run_in_child(configurations[i].c_str(), path.c_str(), options,
+				cacheDirectory, results))
+			success = false;
+	}
+
+	printf("{\n\t\"catalog\": {\"path\": %s, \"size\": %lld",
+		generated ? "null" : json_string(path.c_str()).c_str(),
+		(long long)st.st_size);
+	if (generated) {
+		printf(", \"generated\": {\"strings\": %zu, \"density\": %g, "
+			"\"minLength\": %zu, \"maxLength\": %zu, \"codeSet\": %u, "
+			"\"nonASCIIPercent\": %u, \"seed\": %u}", shape.count,
+			shape.density, shape.minLength, shape.maxLength, shape.codeSet,
+			shape.nonASCIIPercent, shape.seed);
+	}
+	printf("},\n\t\"repeats\": %d,\n\t\"lookups\": %zu,\n"
+		"\t\"configurations\": [\n\t\t%s\n\t]\n}\n", options.repeats,
+		options.lookups, results.c_str());
+
+	remove_directory(directory);
+	return success ? 0 : 1;
+}
@@ -0,0 +1,318 @@
+/*
+ * Copyright 2026, Adrien Destugues, pulkomandy@pulkomandy.tk.
+ * Distributed under the terms of the MIT License.
+ */
+
+#include "CatalogCache.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+
+#include <sys/stat.h>
+
+#include <new>
+
+#include "MappedFile.h"
+#include "SharedImage.h"
+#include "StringTable.h"
+
+
+using BPrivate::CatalogCache;
+using BPrivate::MappedFile;
+using BPrivate::SharedImage;
+
+
+static const uint32_t kCacheMagic = 'ACCF';
+static const uint32_t kCacheVersion = 2;
+	// bump this when the cache or the IDStringTable image format changes
+
+
+static inline size_t
+align_cache_offset(size_t offset)
+{
+	return (offset + 7) & ~(size_t)7;
+}
+
+
+static const uint32_t kHashBasis = 2166136261u;
+
+
+/*!	FNV-1a
+*/
+static uint32_t
+hash_bytes(uint32_t hash, const void* data, size_t size)
+{
+	const uint8_t* bytes = (const uint8_t*)data;
+	for (size_t i = 0; i < size; i++)
+		hash = (hash ^ bytes[i]) * 16777619u;
+	return hash;
+}
+
+
+CatalogCache::CatalogCache(const char* directory, const char* catalogPath)
+	:
+	fDirectory(directory != NULL ? directory : ""),
+	fCatalogPath(catalogPath)
+{
+	// FNV-1a of the catalog path names the cache file and the shared image,
+	// the full path is checked when loading them anyway.
+	fPathHash = hash_bytes(kHashBasis, catalogPath, strlen(catalogPath));
+
+	if (directory != NULL) {
+		char name[32];
+		snprintf(name, sizeof(name), "/%08x.cache", fPathHash);
+		fCachePath = fDirectory + name;
+	}
+}
+
+
+MappedFile*
+CatalogCache::Load(IDStringTable& table, std::string& version,
+	std::string& language, uint32_t& fingerprint)
+{
+	if (fCachePath.empty())
+		return NULL;
+
+	// The table uses the file in place for as long as it exists. That is
+	// safe as cache files are never written to once in place, Store()
+	// replaces them by renaming a new one over them.
+	MappedFile* cache = new(std::nothrow) MappedFile(fCachePath.c_str());
+	if (cache == NULL)
+		return NULL;
+
+	if (cache->InitCheck() != 0 || !_Unserialize(cache->Data(), cache->Size(),
+			table, version, language, fingerprint)) {
+		delete cache;
+		return NULL;
+	}
+	return cache;
+}
+
+
+bool
+CatalogCache::Store(const struct stat& catalogStat, const IDStringTable& table,
+	const char* version, const char* language, uint32_t fingerprint)
+{
+	if (fCachePath.empty())
+		return false;
+
+	// Build the whole file in memory, so it is written with a single call
+	std::vector<char> buffer;
+	if (!_Serialize(catalogStat, table, version, language, fingerprint,
+			buffer))
+		return false;
+
+	if (mkdir(fDirectory.c_str(), 0755) != 0 && errno != EEXIST)
+		return false;
+
+	// Write to a temporary file first, so other processes never see a
+	// partial cache
+	char suffix[32];
+	snprintf(suffix, sizeof(suffix), ".%d", (int)getpid());
+	std::string temporaryPath = fCachePath + suffix;
+
+	int fd = open(temporaryPath.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+	if (fd < 0)
+		return false;
+
+	ssize_t written = write(fd, &buffer[0], buffer.size());
+	close(fd);
+
+	if (written != (ssize_t)buffer.size()
+		|| rename(temporaryPath.c_str(), fCachePath.c_str()) != 0) {
+		unlink(temporaryPath.c_str());
+		return false;
+	}
+	return true;
+}
+
+
+SharedImage*
+CatalogCache::Attach(IDStringTable& table, std::string& version,
+	std::string& language, uint32_t& fingerprint)
+{
+	Header key;
+	if (!_GetKey(key))
+		return NULL;
+	std::string name = _SharedName(key);
+
+	SharedImage* image = new(std::nothrow) SharedImage(name.c_str());
+	if (image == NULL)
+		return NULL;
+
+	if (image->InitCheck() != 0) {
+		delete image;
+		return NULL;
+	}
+	if (!_Unserialize(image->Data(), image->Size(), table, version, language,
+			fingerprint)) {
+		// Images still being published don't have their magic yet, the
+		// others are outdated and no process will use them anymore.
+		if (image->Size() >= sizeof(uint32_t)
+			&& __atomic_load_n((const uint32_t*)image->Data(),
+				__ATOMIC_ACQUIRE) == kCacheMagic)
+			SharedImage::Remove(name.c_str());
+		delete image;
+		return NULL;
+	}
+	return image;
+}
+
+
+SharedImage*
+CatalogCache::Publish(const struct stat& catalogStat,
+	const IDStringTable& table, const char* version, const char* language,
+	uint32_t fingerprint)
+{
+	std::vector<char> buffer;
+	if (!_Serialize(catalogStat, table, version, language, fingerprint,
+			buffer))
+		return NULL;
+
+	Header key;
+	_SetKey(catalogStat, key);
+	SharedImage* image = new(std::nothrow) SharedImage(
+		_SharedName(key).c_str(), &buffer[0], buffer.size());
+	if (image != NULL && image->InitCheck() != 0) {
+		delete image;
+		return NULL;
+	}
+	return image;
+}
+
+
+/*!	Names the shared image for the catalog file with the given key. On
+	Haiku, areas can only be deleted by the teams that created or cloned
+	them, and clones have the same name, so an outdated image would be found
+	again and again while one of them runs. The key is part of the name
+	there, so once the catalog changes, outdated images are never found.
+	Shared memory objects elsewhere are removed instead, so they don't pile
+	up. The name fits in B_OS_NAME_LENGTH.
+*/
+std::string
+CatalogCache::_SharedName(const Header& key) const
+{
+	char name[32];
+#ifdef __HAIKU__
+	uint32_t keyHash = hash_bytes(kHashBasis, &key.device,
+		sizeof(key.device));
+	keyHash = hash_bytes(keyHash, &key.inode, sizeof(key.inode));
+	keyHash = hash_bytes(keyHash, &key.modificationTime,
+		sizeof(key.modificationTime));
+	keyHash = hash_bytes(keyHash, &key.size, sizeof(key.size));
+	snprintf(name, sizeof(name), "/amigacatalog-%08x-%08x", fPathHash,
+		keyHash);
+#else
+	snprintf(name, sizeof(name), "/amigacatalog-%08x", fPathHash);
+#endif
+	return name;
+}
+
+
+/*!	Gets the key of the catalog file as it is now, to check a cache against.
+*/
+bool
+CatalogCache::_GetKey(Header& header) const
+{
+	struct stat st;
+	if (stat(fCatalogPath.c_str(), &st) != 0)
+		return false;
+
+	_SetKey(st, header);
+	return true;
+}
+
+
+void
+CatalogCache::_SetKey(const struct stat& catalogStat, Header& header) const
+{
+	memset(&header, 0, sizeof(header));
+	header.magic = kCacheMagic;
+	header.version = kCacheVersion;
+	header.device = catalogStat.st_dev;
+	header.inode = catalogStat.st_ino;
+	header.modificationTime = (int64_t)catalogStat.st_mtim.tv_sec * 1000000000
+		+ catalogStat.st_mtim.tv_nsec;
+	header.size = catalogStat.st_size;
+	header.pathLength = fCatalogPath.size();
+}
+
+
+bool
+CatalogCache::_Serialize(const struct stat& catalogStat,
+	const IDStringTable& table, const char* version, const char* language,
+	uint32_t fingerprint, std::vector<char>& buffer) const
+{
+	Header header;
+	_SetKey(catalogStat, header);
+
+	header.fingerprint = fingerprint;
+	header.versionLength = strlen(version);
+	header.languageLength = strlen(language);
+
+	size_t imageOffset = align_cache_offset(sizeof(header) + header.pathLength
+		+ header.versionLength + header.languageLength + 3);
+
+	try {
+		buffer.resize(imageOffset + table.ImageSize());
+	} catch (const std::bad_alloc&) {
+		return false;
+	}
+
+	char* data = &buffer[0];
+	memcpy(data, &header, sizeof(header));
+	char* strings = data + sizeof(header);
+	memcpy(strings, fCatalogPath.c_str(), header.pathLength + 1);
+	strings += header.pathLength + 1;
+	memcpy(strings, version, header.versionLength + 1);
+	strings += header.versionLength + 1;
+	memcpy(strings, language, header.languageLength + 1);
+	table.WriteImage(data + imageOffset);
+	return true;
+}
+
+
+bool
+CatalogCache::_Unserialize(const uint8_t* data, size_t size,
+	IDStringTable& table, std::string& version, std::string& language,
+	uint32_t& fingerprint) const
+{
+	Header key;
+	Header header;
+	if (size < sizeof(header) || !_GetKey(key))
+		return false;
+
+	// Shared images are published with the magic written last
+	if (__atomic_load_n((const uint32_t*)data, __ATOMIC_ACQUIRE)
+			!= kCacheMagic)
+		return false;
+	memcpy(&header, data, sizeof(header));
+
+	size_t stringsSize = (uint64_t)header.pathLength + header.versionLength
+		+ header.languageLength + 3;
+	size_t imageOffset = align_cache_offset(sizeof(header) + stringsSize);
+	const char* strings = (const char*)data + sizeof(header);
+
+	if (header.version != kCacheVersion
+		|| header.device != key.device || header.inode != key.inode
+		|| header.modificationTime != key.modificationTime
+		|| header.size != key.size || header.pathLength != key.pathLength
+		|| imageOffset > size
+		|| memcmp(strings, fCatalogPath.c_str(), key.pathLength + 1) != 0
+		|| strings[stringsSize - 1] != '\0')
+		return false;
+
+	// Shared images are rounded up to a page, the table ignores the padding
+	if (!table.SetImage(data + imageOffset, size - imageOffset))
+		return false;
+
+	strings += header.pathLength + 1;
+	version.assign(strings, header.versionLength);
+	strings += header.versionLength + 1;
+	language.assign(strings, header.languageLength);
+	fingerprint = header.fingerprint;
+	return true;
+}
@@ -0,0 +1,99 @@
+/*
+ * Copyright 2026, Adrien Destugues, pulkomandy@pulkomandy.tk.
+ * Distributed under the terms of the MIT License.
+ */
+#ifndef _CATALOG_CACHE_H_
+#define _CATALOG_CACHE_H_
+
+
+#include <stdint.h>
+
+#include <string>
+#include <vector>
+
+
+struct stat;
+
+namespace BPrivate {
+
+
+class IDStringTable;
+class MappedFile;
+class SharedImage;
+
+
+/*	Cache of decoded catalogs. Each catalog file gets a cache file holding
+ *	its strings already converted to UTF-8 and indexed, as an IDStringTable
+ *	image, along with the version, language and fingerprint read from it.
+ *
+ *	The cache file is keyed by the path, device, inode, modification time and
+ *	size of the catalog file. When any of them changed, Load() fails and the
+ *	catalog has to be parsed again. Store() and Publish() take these from
+ *	the file the strings were read from, as it was before reading it, so a
+ *	catalog changing in the meantime doesn't get the old strings cached
+ *	under its new identity.
+ *
+ *	The same image can also be published in shared memory with Publish(),
+ *	for when there is no cache directory to write to. Other processes then
+ *	attach to it with Attach(), which checks the key the same way, and
+ *	removes the image if it is outdated. On Haiku, images can't be removed
+ *	by other processes, so the key is part of their name instead.
+ */
+class CatalogCache {
+	public:
+		CatalogCache(const char* directory, const char* catalogPath);
+			// directory may be NULL to only use shared memory
+
+		MappedFile* Load(IDStringTable& table, std::string& version,
+			std::string& language, uint32_t& fingerprint);
+			// On success, the table uses the returned mapping in place,
+			// which the caller must keep until it's done with the table.
+		bool Store(const struct stat& catalogStat,
+			const IDStringTable& table, const char* version,
+			const char* language, uint32_t fingerprint);
+
+		SharedImage* Attach(IDStringTable& table, std::string& version,
+			std::string& language, uint32_t& fingerprint);
+			// same as Load(), from shared memory
+		SharedImage* Publish(const struct stat& catalogStat,
+			const IDStringTable& table, const char* version,
+			const char* language, uint32_t fingerprint);
+			// The image stays published as long as the returned object
+			// exists, or some process is attached to it.
+
+	private:
+		struct Header {
+			uint32_t	magic;
+			uint32_t	version;
+			uint64_t	device;
+			uint64_t	inode;
+			int64_t		modificationTime;
+			uint64_t	size;
+			uint32_t	fingerprint;
+			uint32_t	pathLength;
+			uint32_t	versionLength;
+			uint32_t	languageLength;
+		};
+
+		std::string _SharedName(const Header& key) const;
+		bool _GetKey(Header& header) const;
+		void _SetKey(const struct stat& catalogStat, Header& header) const;
+		bool _Serialize(const struct stat& catalogStat,
+			const IDStringTable& table, const char* version,
+			const char* language, uint32_t fingerprint,
+			std::vector<char>& buffer) const;
+		bool _Unserialize(const uint8_t* data, size_t size,
+			IDStringTable& table, std::string& version,
+			std::string& language, uint32_t& fingerprint) const;
+
+		std::string		fDirectory;
+		std::string		fCachePath;
+		uint32_t		fPathHash;
+		std::string		fCatalogPath;
+};
+
+
+} // namespace BPrivate
+
+
+#endif /* _CATALOG_CACHE_H_ */
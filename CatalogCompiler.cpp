@@ -0,0 +1,351 @@
+/*
+ * Copyright 2026, Adrien Destugues, pulkomandy@pulkomandy.tk.
+ * Distributed under the terms of the MIT License.
+ */
+
+/*	Compiles a tree of catkeys files into Amiga catalogs, on several threads.
+ *
+ *	Every file ending in .catkeys below the source directory is compiled to a
+ *	file with the same relative path, ending in .catalog, below the target
+ *	directory. The files use the plain text catkeys format: a header line
+ *	with the format version, language, signature and fingerprint separated by
+ *	tabs, then one line per string with the key, context, comment and
+ *	translation. Amiga catalogs identify strings by number, so the key must
+ *	be the numeric ID of the string; context and comment are ignored.
+ */
+
+
+#include <dirent.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include <sys/stat.h>
+
+#include <algorithm>
+#include <atomic>
+#include <new>
+#include <string>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+#include "CatalogAttributes.h"
+#include "CTLGWriter.h"
+#include "MappedFile.h"
+
+
+using BPrivate::CTLGWriter;
+using BPrivate::write_catalog_attributes;
+using BPrivate::MappedFile;
+
+
+static const char* kSourceExtension = ".catkeys";
+static const char* kTargetExtension = ".catalog";
+
+
+struct CompileJob {
+	std::string	source;
+	std::string	target;
+};
+
+
+/*!	Adds a job for each catkeys file below \a sourceDirectory. Returns false
+	if a directory or file couldn't be read, after telling which.
+*/
+static bool
+find_sources(const std::string& sourceDirectory,
+	const std::string& targetDirectory, std::vector<CompileJob>& jobs)
+{
+	DIR* dir = opendir(sourceDirectory.c_str());
+	if (dir == NULL) {
+		fprintf(stderr, "catcompile: %s: %s\n", sourceDirectory.c_str(),
+			strerror(errno));
+		return false;
+	}
+
+	bool success = true;
+	size_t extensionLength = strlen(kSourceExtension);
+	while (struct dirent* entry = readdir(dir)) {
+		if (strcmp(entry->d_name, ".") == 0 || strcmp(entry->d_name, "..") == 0)
+			continue;
+
+		std::string name = entry->d_name;
+		std::string path = sourceDirectory + "/" + name;
+		struct stat st;
+		if (stat(path.c_str(), &st) != 0) {
+			fprintf(stderr, "catcompile: %s: %s\n", path.c_str(),
+				strerror(errno));
+			success = false;
+			continue;
+		}
+
+		if (S_ISDIR(st.st_mode)) {
+			if (!find_sources(path, targetDirectory + "/" + name, jobs))
+				success = false;
+			continue;
+		}
+
+		if (name.size() <= extensionLength
+			|| name.compare(name.size() - extensionLength, extensionLength,
+				kSourceExtension) != 0)
+			continue;
+
+		CompileJob job;
+		job.source = path;
+		job.target = targetDirectory + "/"
+			+ name.substr(0, name.size() - extensionLength) + kTargetExtension;
+		jobs.push_back(job);
+	}
+
+	closedir(dir);
+	return success;
+}
+
+
+static bool
+create_directories(const std::string& path)
+{
+	for (size_t slash = path.find('/', 1); ; slash = path.find('/', slash + 1)) {
+		std::string directory = path.substr(0, slash);
+		if (mkdir(directory.c_str(), 0755) != 0 && errno != EEXIST)
+			return false;
+		if (slash == std::string::npos)
+			return true;
+	}
+}
+
+
+/*!	Splits a line of a catkeys file in its tab separated fields, and removes
+	the escaping of tabs, newlines and backslashes in place.
+*/
+static void
+split_line(char* line, char* lineEnd, std::vector<char*>& fields)
+{
+	fields.clear();
+	fields.push_back(line);
+
+	char* target = line;
+	for (char* source = line; source < lineEnd; source++) {
+		if (*source == '\t') {
+			*target++ = '\0';
+			fields.push_back(target);
+		} else if (*source == '\\' && source + 1 < lineEnd) {
+			source++;
+			if (*source == 'n')
+				*target++ = '\n';
+			else if (*source == 't')
+				*target++ = '\t';
+			else
+				*target++ = *source;
+		} else
+			*target++ = *source;
+	}
+	*target = '\0';
+}
+
+
+static bool
+compile(const CompileJob& job)
+{
+	MappedFile source(job.source.c_str());
+	if (source.InitCheck() != 0) {
+		fprintf(stderr, "catcompile: %s: %s\n", job.source.c_str(),
+			strerror(source.InitCheck()));
+		return false;
+	}
+
+	// The mapping is read-only, and unescaping needs to modify the text
+	std::vector<char> text((const char*)source.Data(),
+		(const char*)source.Data() + source.Size());
+	text.push_back('\0');
+
+	std::string language;
+	std::string signature;
+	CTLGWriter* writer = NULL;
+	std::vector<char*> fields;
+	int lineNumber = 0;
+	bool success = true;
+
+	for (char* line = &text[0]; *line != '\0' && success; ) {
+		char* lineEnd = strchr(line, '\n');
+		if (lineEnd == NULL)
+			lineEnd = line + strlen(line);
+		char* next = *lineEnd != '\0' ? lineEnd + 1 : lineEnd;
+		if (lineEnd > line && lineEnd[-1] == '\r')
+			lineEnd--;
+		lineNumber++;
+
+		split_line(line, lineEnd, fields);
+		line = next;
+
+		if (writer == NULL) {
+			// Header: version, language, signature, fingerprint
+			if (fields.size() < 3 || strcmp(fields[0], "1") != 0) {
+				fprintf(stderr, "catcompile: %s: not a catkeys file\n",
+					job.source.c_str());
+				return false;
+			}
+			language = fields[1];
+			signature = fields[2];
+			writer = new(std::nothrow) CTLGWriter(signature.c_str(),
+				language.c_str());
+			if (writer == NULL) {
+				fprintf(stderr, "catcompile: %s: %s\n", job.source.c_str(),
+					strerror(ENOMEM));
+				return false;
+			}
+			continue;
+		}
+
+		if (fields.size() == 1 && fields[0][0] == '\0')
+			continue;
+
+		// strtoul() takes negative numbers, and longs may be larger than
+		// IDs
+		char* end;
+		errno = 0;
+		unsigned long id = strtoul(fields[0], &end, 10);
+		if (fields.size() != 4 || end == fields[0] || *end != '\0'
+			|| errno == ERANGE || id > UINT32_MAX
+			|| strchr(fields[0], '-') != NULL) {
+			fprintf(stderr, "catcompile: %s:%d: expected a numeric ID and 3 "
+				"fields\n", job.source.c_str(), lineNumber);
+			success = false;
+			break;
+		}
+
+		success = writer->AddString(id, fields[3], strlen(fields[3]));
+		if (!success) {
+			fprintf(stderr, "catcompile: %s: %s\n", job.source.c_str(),
+				strerror(ENOMEM));
+		}
+	}
+
+	if (writer == NULL) {
+		fprintf(stderr, "catcompile: %s: empty file, no catkeys header\n",
+			job.source.c_str());
+		return false;
+	}
+
+	std::vector<uint8_t> buffer;
+	uint32_t fingerprint = 0;
+	if (success) {
+		success = writer->Flatten(buffer);
+		fingerprint = writer->Fingerprint();
+		if (!success) {
+			fprintf(stderr, "catcompile: %s: %s\n", job.source.c_str(),
+				strerror(ENOMEM));
+		}
+	}
+	delete writer;
+	if (!success)
+		return false;
+
+	size_t slash = job.target.rfind('/');
+	if (slash != std::string::npos && slash > 0
+		&& !create_directories(job.target.substr(0, slash))) {
+		fprintf(stderr, "catcompile: %s: %s\n", job.target.c_str(),
+			strerror(errno));
+		return false;
+	}
+
+	int fd = open(job.target.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+	if (fd < 0) {
+		fprintf(stderr, "catcompile: %s: %s\n", job.target.c_str(),
+			strerror(errno));
+		return false;
+	}
+
+	ssize_t written = write(fd, &buffer[0], buffer.size());
+
+	// The attributes let the add-on skip files that are not what it looks
+	// for without parsing them. Not all file systems support them, and
+	// catalogs work without.
+	write_catalog_attributes(fd, signature.c_str(), language.c_str(),
+		fingerprint);
+	close(fd);
+	if (written != (ssize_t)buffer.size()) {
+		fprintf(stderr, "catcompile: %s: write failed\n", job.target.c_str());
+		unlink(job.target.c_str());
+		return false;
+	}
+	return true;
+}
+
+
+static void
+usage()
+{
+	fprintf(stderr, "usage: catcompile [-j <threads>] <source directory> "
+		"<target directory>\n");
+	exit(1);
+}
+
+
+int
+main(int argc, char** argv)
+{
+	unsigned threadCount = std::thread::hardware_concurrency();
+
+	int option;
+	while ((option = getopt(argc, argv, "j:")) != -1) {
+		if (option != 'j')
+			usage();
+
+		char* end;
+		errno = 0;
+		unsigned long count = strtoul(optarg, &end, 10);
+		if (end == optarg || *end != '\0' || errno == ERANGE || count == 0
+			|| count > UINT_MAX || strchr(optarg, '-') != NULL)
+			usage();
+		threadCount = count;
+	}
+	if (argc - optind != 2)
+		usage();
+
+	std::vector<CompileJob> jobs;
+	if (!find_sources(argv[optind], argv[optind + 1], jobs))
+		return 1;
+
+	// Files vary a lot in size, so workers take the next file from a shared
+	// counter whenever they are done with one, rather than getting a fixed
+	// share of the list.
+	std::atomic<size_t> nextJob(0);
+	std::atomic<size_t> failed(0);
+	std::vector<std::thread> workers;
+
+	auto work = [&]() {
+		for (size_t job; (job = nextJob++) < jobs.size(); ) {
+			if (!compile(jobs[job]))
+				failed++;
+		}
+	};
+
+	// When no more threads can be started, the ones that could do all the
+	// work. The list is allocated first, so that adding a started thread
+	// to it can't throw.
+	threadCount = std::max(1u, std::min(threadCount, (unsigned)jobs.size()));
+	try {
+		workers.reserve(threadCount);
+		for (unsigned i = 0; i < threadCount; i++)
+			workers.push_back(std::thread(work));
+	} catch (const std::system_error&) {
+	} catch (const std::bad_alloc&) {
+	}
+	if (workers.empty())
+		work();
+	for (size_t i = 0; i < workers.size(); i++)
+		workers[i].join();
+
+	if (failed > 0) {
+		fprintf(stderr, "catcompile: %zu of %zu catalogs failed\n",
+			failed.load(), jobs.size());
+		return 1;
+	}
+	return 0;
+}
@@ -0,0 +1,147 @@
+/*
+ * Copyright 2026, Adrien Destugues, pulkomandy@pulkomandy.tk.
+ * Distributed under the terms of the MIT License.
+ */
+
+/*	Generates a catalog with random strings, see RandomCatalog.h. */
+
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include <string>
+#include <vector>
+
+#include "CatalogAttributes.h"
+#include "RandomCatalog.h"
+
+
+using BPrivate::generate_random_catalog;
+using BPrivate::RandomCatalogShape;
+using BPrivate::write_catalog_attributes;
+
+
+static void
+usage()
+{
+	fprintf(stderr, "usage: catgenerate [-n <strings>] [-d <density>] "
+		"[-l <min>[-<max>]]\n"
+		"\t[-c <code set>] [-x <non-ASCII percent>] [-s <seed>]\n"
+		"\t[-S <signature>] [-L <language>] <catalog>\n");
+	exit(1);
+}
+
+
+static unsigned long
+parse_number(const char* string)
+{
+	char* end;
+	unsigned long value = strtoul(string, &end, 10);
+	if (end == string || *end != '\0')
+		usage();
+	return value;
+}
+
+
+int
+main(int argc, char** argv)
+{
+	RandomCatalogShape shape;
+	const char* signature = "x-vnd.Amiga-GeneratedCatalog";
+	const char* language = "english";
+
+	int option;
+	while ((option = getopt(argc, argv, "n:d:l:c:x:s:S:L:")) != -1) {
+		switch (option) {
+			case 'n':
+				shape.count = parse_number(optarg);
+				break;
+			case 'd':
+			{
+				char* end;
+				shape.density = strtod(optarg, &end);
+				if (end == optarg || *end != '\0' || shape.density <= 0
+					|| shape.density > 1)
+					usage();
+				break;
+			}
+			case 'l':
+			{
+				std::string lengths = optarg;
+				size_t dash = lengths.find('-');
+				shape.minLength = shape.maxLength = parse_number(
+					lengths.substr(0, dash).c_str());
+				if (dash != std::string::npos)
+					shape.maxLength = parse_number(lengths.c_str() + dash + 1);
+				if (shape.maxLength < shape.minLength)
+					usage();
+				break;
+			}
+			case 'c':
+			{
+				// 0 would let the writer pick the code set of the strings
+				unsigned long codeSet = parse_number(optarg);
+				if (codeSet == 0 || codeSet > UINT32_MAX)
+					usage();
+				shape.codeSet = codeSet;
+				break;
+			}
+			case 'x':
+				shape.nonASCIIPercent = parse_number(optarg);
+				if (shape.nonASCIIPercent > 100)
+					usage();
+				break;
+			case 's':
+				shape.seed = parse_number(optarg);
+				break;
+			case 'S':
+				signature = optarg;
+				break;
+			case 'L':
+				language = optarg;
+				break;
+			default:
+				usage();
+		}
+	}
+	if (argc - optind != 1)
+		usage();
+
+	std::vector<uint8_t> buffer;
+	uint32_t fingerprint;
+	int error = generate_random_catalog(shape, signature, language, buffer,
+		fingerprint);
+	if (error == EINVAL) {
+		fprintf(stderr, "catgenerate: too many strings for this density\n");
+		return 1;
+	}
+	if (error == E2BIG) {
+		fprintf(stderr, "catgenerate: catalog too large\n");
+		return 1;
+	}
+	if (error != 0) {
+		fprintf(stderr, "catgenerate: out of memory\n");
+		return 1;
+	}
+
+	const char* path = argv[optind];
+	int fd = open(path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+	if (fd < 0) {
+		fprintf(stderr, "catgenerate: %s: %s\n", path, strerror(errno));
+		return 1;
+	}
+
+	ssize_t written = write(fd, &buffer[0], buffer.size());
+	write_catalog_attributes(fd, signature, language, fingerprint);
+	close(fd);
+	if (written != (ssize_t)buffer.size()) {
+		fprintf(stderr, "catgenerate: %s: write failed\n", path);
+		unlink(path);
+		return 1;
+	}
+	return 0;
+}
@@ -0,0 +1,460 @@
+/*
+ * Copyright 2026, Adrien Destugues, pulkomandy@pulkomandy.tk.
+ * Distributed under the terms of the MIT License.
+ */
+
+#include "CatalogIndex.h"
+
+#include <dirent.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <fnmatch.h>
+#include <string.h>
+#include <unistd.h>
+
+#include <sys/stat.h>
+
+#include <new>
+#include <set>
+
+#include <AppFileInfo.h>
+#include <Autolock.h>
+#include <File.h>
+#include <Language.h>
+#include <LocaleRoster.h>
+#include <Looper.h>
+#include <Message.h>
+#include <NodeMonitor.h>
+
+#include "CatalogAttributes.h"
+
+
+using BPrivate::CatalogIndex;
+
+
+/*	Forgets everything the index knows when an entry is created, removed or
+ *	renamed in one of the watched folders.
+ */
+class CatalogIndex::Watcher : public BLooper {
+	public:
+		Watcher(CatalogIndex& index)
+			:
+			BLooper("catalog index watcher", B_LOW_PRIORITY),
+			fIndex(index)
+		{
+		}
+
+		virtual void MessageReceived(BMessage* message)
+		{
+			if (message->what == B_NODE_MONITOR)
+				fIndex.Invalidate();
+			else
+				BLooper::MessageReceived(message);
+		}
+
+	private:
+		CatalogIndex&	fIndex;
+};
+
+
+CatalogIndex::CatalogIndex(const char* extension)
+	:
+	fLock("catalog index"),
+	fExtension(extension),
+	fWatcher(NULL),
+	fWatching(false),
+	fValid(false),
+	fHasLanguageCodes(false)
+{
+}
+
+
+CatalogIndex::~CatalogIndex()
+{
+	if (fWatcher != NULL) {
+		stop_watching(fWatcher);
+		if (fWatcher->Lock())
+			fWatcher->Quit();
+	}
+}
+
+
+status_t
+CatalogIndex::GetAvailableLanguages(BMessage* languages,
+	const std::vector<BString>& folders, const char* sigPattern,
+	const char* langPattern)
+{
+	if (languages == NULL)
+		return B_BAD_VALUE;
+
+	BAutolock locker(fLock);
+
+	if (!fValid || folders != fRoots)
+		_Rebuild(folders);
+
+	// The same language may be there for several signatures or folders
+	std::set<BString> added;
+	for (size_t i = 0; i < fCatalogs.size(); i++) {
+		const Catalog& catalog = fCatalogs[i];
+		if (sigPattern != NULL
+			&& fnmatch(sigPattern, catalog.signature.String(), 0) != 0)
+			continue;
+
+		const char* code = _LanguageCode(catalog.language);
+		if (langPattern != NULL && fnmatch(langPattern, code, 0) != 0
+			&& fnmatch(langPattern, catalog.language.String(), 0) != 0)
+			continue;
+
+		if (added.insert(code).second)
+			languages->AddString("language", code);
+	}
+
+	return B_OK;
+}
+
+
+bool
+CatalogIndex::FindCatalog(const std::vector<BString>& folders,
+	const entry_ref& owner, const char* language, uint32 fingerprint,
+	std::vector<BString>& paths, int32& probes)
+{
+	BAutolock locker(fLock);
+
+	// The attributes of a catalog are checked against the executable and
+	// the fingerprint, so they are part of what is remembered
+	BString key;
+	key << owner.device << ":" << owner.directory << ":" << fingerprint
+		<< ":" << language << "/" << owner.name;
+
+	// Installing or removing a catalog, or the folder it is in, is reported
+	// by the node monitor, so what was found is used as it is until then.
+	if (fWatching && folders == fRoots) {
+		std::map<BString, std::vector<BString> >::const_iterator found
+			= fLookups.find(key);
+		if (found != fLookups.end()) {
+			paths = found->second;
+			return !paths.empty();
+		}
+	}
+
+	// Lookups are only remembered when all the folders are watched
+	bool watching = _StartWatching(folders, probes);
+
+	BString name(owner.name);
+	name << fExtension;
+	BString mimeSignature;
+	bool hasMimeSignature = false;
+
+	paths.clear();
+	for (size_t i = 0; i < folders.size(); i++) {
+		// Creating the language folder would be reported by the node
+		// monitor, it can't be there in a missing Catalogs/ folder
+		if (watching && !fRootExists[i])
+			continue;
+
+		BString folderPath(folders[i]);
+		if (folderPath.String()[folderPath.Length() - 1] != '/')
+			folderPath << "/";
+		folderPath << language;
+
+		probes++;
+		int folder = open(folderPath.String(), O_RDONLY | O_DIRECTORY);
+		if (folder < 0)
+			continue;
+
+		// The folder is watched before looking for the catalog, so that
+		// installing it right after is noticed
+		if (watching && !_Watch(folder))
+			watching = false;
+
+		probes++;
+		int fd = openat(folder, name.String(), O_RDONLY);
+		close(folder);
+		if (fd < 0)
+			continue;
+
+		// Reading attributes is cheaper than mapping and parsing a
+		// file which is not the right catalog after all. The signature
+		// of the executable is only needed then.
+		struct stat st;
+		bool matches = fstat(fd, &st) == 0 && S_ISREG(st.st_mode);
+		if (matches && !hasMimeSignature) {
+			probes++;
+			hasMimeSignature = true;
+			_GetMimeSignature(owner, mimeSignature);
+		}
+		matches = matches && catalog_attributes_match(fd, owner.name,
+			mimeSignature.Length() > 0 ? mimeSignature.String() : NULL,
+			fingerprint);
+		close(fd);
+
+		if (matches) {
+			folderPath << "/" << name;
+			paths.push_back(folderPath);
+		}
+	}
+
+	if (watching)
+		fLookups[key] = paths;
+	return !paths.empty();
+}
+
+
+void
+CatalogIndex::GetNativeName(const char* code, BString& name)
+{
+	BAutolock locker(fLock);
+
+	std::map<BString, BString>::const_iterator found = fNativeNames.find(code);
+	if (found == fNativeNames.end()) {
+		BLanguage language(code);
+		BString nativeName;
+		language.GetNativeName(nativeName);
+		found = fNativeNames.insert(std::make_pair(BString(code),
+			nativeName)).first;
+	}
+
+	name = found->second;
+}
+
+
+void
+CatalogIndex::Invalidate()
+{
+	BAutolock locker(fLock);
+
+	// Watching starts again with the next lookup, for the folders that
+	// exist then
+	if (fWatcher != NULL)
+		stop_watching(fWatcher);
+	fWatching = false;
+	fValid = false;
+	fLookups.clear();
+}
+
+
+/*!	Sets \a signature to the MIME signature of the executable, as
+	DefaultCatalog uses to identify catalogs, or empties it if there is none.
+*/
+void
+CatalogIndex::_GetMimeSignature(const entry_ref& owner, BString& signature)
+{
+	signature.Truncate(0);
+
+	BFile file(&owner, B_READ_ONLY);
+	BAppFileInfo info(&file);
+	char buffer[B_MIME_TYPE_LENGTH];
+	if (info.InitCheck() == B_OK && info.GetSignature(buffer) == B_OK)
+		signature = buffer;
+}
+
+
+/*!	Watches the Catalogs/ folders, or the nearest existing parent of the
+	missing ones, so that creating them is reported. Remembers which ones
+	exist, and returns whether they are all watched.
+*/
+bool
+CatalogIndex::_StartWatching(const std::vector<BString>& folders,
+	int32& probes)
+{
+	if (folders != fRoots) {
+		Invalidate();
+		fRoots = folders;
+	}
+	if (fWatching)
+		return true;
+
+	if (fWatcher == NULL) {
+		Watcher* watcher = new(std::nothrow) Watcher(*this);
+		if (watcher == NULL)
+			return false;
+		if (watcher->Run() < 0) {
+			delete watcher;
+			return false;
+		}
+		fWatcher = watcher;
+	}
+
+	fRootExists.assign(folders.size(), false);
+	for (size_t i = 0; i < folders.size(); i++) {
+		bool exists;
+		if (!_WatchFolder(folders[i], exists, probes))
+			return false;
+		fRootExists[i] = exists;
+	}
+
+	fWatching = true;
+	return true;
+}
+
+
+/*!	Watches the folder at \a path if it exists, or else its nearest
+	existing parent. Sets \a exists accordingly, and increases \a probes by
+	the number of folders looked up.
+*/
+bool
+CatalogIndex::_WatchFolder(const BString& path, bool& exists, int32& probes)
+{
+	exists = false;
+
+	probes++;
+	int fd = open(path.String(), O_RDONLY | O_DIRECTORY);
+	if (fd < 0) {
+		if (errno != ENOENT && errno != ENOTDIR)
+			return false;
+
+		BString parent(path);
+		while (parent.Length() > 1
+			&& parent.String()[parent.Length() - 1] == '/')
+			parent.Truncate(parent.Length() - 1);
+		int32 slash = parent.FindLast('/');
+		if (slash < 0 || parent.Length() <= 1)
+			return false;
+		parent.Truncate(slash > 0 ? slash : 1);
+
+		bool parentExists;
+		if (!_WatchFolder(parent, parentExists, probes))
+			return false;
+
+		// It may have been created before its parent was watched
+		probes++;
+		fd = open(path.String(), O_RDONLY | O_DIRECTORY);
+		if (fd < 0)
+			return true;
+	}
+
+	exists = true;
+	bool watched = _Watch(fd);
+	close(fd);
+	return watched;
+}
+
+
+/*!	Starts watching the entries of the folder open as \a fd.
+*/
+bool
+CatalogIndex::_Watch(int fd)
+{
+	struct stat st;
+	if (fstat(fd, &st) != 0)
+		return false;
+
+	node_ref node;
+	node.device = st.st_dev;
+	node.node = st.st_ino;
+	return watch_node(&node, B_WATCH_DIRECTORY, fWatcher) == B_OK;
+}
+
+
+void
+CatalogIndex::_Rebuild(const std::vector<BString>& folders)
+{
+	int32 probes = 0;
+	bool watching = _StartWatching(folders, probes);
+	fCatalogs.clear();
+
+	// The index is only kept when all the folders it was built from are
+	// watched, otherwise the next enumeration builds it again
+	for (size_t i = 0; i < folders.size(); i++) {
+		if (watching && !fRootExists[i])
+			continue;
+		if (!_ScanLanguages(folders[i]))
+			watching = false;
+	}
+
+	fValid = watching;
+}
+
+
+bool
+CatalogIndex::_ScanLanguages(const BString& path)
+{
+	DIR* dir = opendir(path.String());
+	if (dir == NULL)
+		return true;
+
+	bool watched = true;
+	while (struct dirent* entry = readdir(dir)) {
+		if (strcmp(entry->d_name, ".") == 0 || strcmp(entry->d_name, "..") == 0)
+			continue;
+
+		BString languagePath(path);
+		if (path.String()[path.Length() - 1] != '/')
+			languagePath << "/";
+		languagePath << entry->d_name;
+		if (!_ScanCatalogs(languagePath, entry->d_name))
+			watched = false;
+	}
+
+	closedir(dir);
+	return watched;
+}
+
+
+/*!	Returns whether the folder is watched, or is not a folder at all.
+*/
+bool
+CatalogIndex::_ScanCatalogs(const BString& path, const char* language)
+{
+	DIR* dir = opendir(path.String());
+	if (dir == NULL)
+		return true;
+
+	bool watched = _Watch(dirfd(dir));
+
+	size_t extensionLength = fExtension.Length();
+	while (struct dirent* entry = readdir(dir)) {
+		size_t length = strlen(entry->d_name);
+		if (length <= extensionLength
+			|| strcmp(entry->d_name + length - extensionLength,
+				fExtension.String()) != 0)
+			continue;
+
+		Catalog catalog;
+		catalog.signature.SetTo(entry->d_name, length - extensionLength);
+		catalog.language = language;
+		catalog.path = path;
+		catalog.path << "/" << entry->d_name;
+		fCatalogs.push_back(catalog);
+	}
+
+	closedir(dir);
+	return watched;
+}
+
+
+/*!	Catalogs are stored by native language name, but the locale roster deals
+	with language codes. The names of all the languages it knows about are
+	looked up once, the first time they are needed. Returns the native name
+	itself for unknown languages.
+*/
+const char*
+CatalogIndex::_LanguageCode(const BString& nativeName)
+{
+	if (!fHasLanguageCodes) {
+		fHasLanguageCodes = true;
+
+		BMessage message;
+		BLocaleRoster::Default()->GetAvailableLanguages(&message);
+
+		const char* code;
+		for (int32 i = 0; message.FindString("language", i, &code) == B_OK;
+				i++) {
+			BLanguage language(code);
+			BString name;
+			if (language.GetNativeName(name) != B_OK)
+				continue;
+
+			// The first code is the generic one, before the variants
+			fLanguageCodes.insert(std::make_pair(name.ToLower(),
+				BString(code)));
+		}
+	}
+
+	BString name(nativeName);
+	std::map<BString, BString>::const_iterator found
+		= fLanguageCodes.find(name.ToLower());
+	if (found == fLanguageCodes.end())
+		return nativeName.String();
+	return found->second.String();
+}
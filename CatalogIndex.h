@@ -0,0 +1,108 @@
+/*
+ * Copyright 2026, Adrien Destugues, pulkomandy@pulkomandy.tk.
+ * Distributed under the terms of the MIT License.
+ */
+#ifndef _CATALOG_INDEX_H_
+#define _CATALOG_INDEX_H_
+
+
+#include <map>
+#include <vector>
+
+#include <Locker.h>
+#include <String.h>
+
+
+class BMessage;
+struct entry_ref;
+
+namespace BPrivate {
+
+
+/*	In-memory index of the catalogs found in a list of Catalogs/ folders.
+ *	Each catalog is stored there as <language>/<signature><extension>, where
+ *	language is the native name of the language.
+ *
+ *	The index is built by the first enumeration, and FindCatalog() remembers
+ *	where the catalog for a signature and language was found, or that there
+ *	was none. Both are trusted until Invalidate() is called, which happens
+ *	when the node monitor reports that an entry was created, removed or
+ *	renamed in one of the folders looked in. The Catalogs/ folders are
+ *	watched, or their nearest existing parent, and so is every language
+ *	folder looked in, so catalogs installed by other processes are still
+ *	found without checking the filesystem on each lookup.
+ */
+class CatalogIndex {
+	public:
+		CatalogIndex(const char* extension);
+		~CatalogIndex();
+
+		status_t GetAvailableLanguages(BMessage* languages,
+			const std::vector<BString>& folders, const char* sigPattern,
+			const char* langPattern);
+			// Adds the code of each language a catalog matching the
+			// patterns exists for, as "language" strings. The patterns are
+			// shell wildcards matched against the signature and the
+			// language code or native name, NULL matches everything.
+		bool FindCatalog(const std::vector<BString>& folders,
+			const entry_ref& owner, const char* language,
+			uint32 fingerprint, std::vector<BString>& paths,
+			int32& probes);
+			// Sets paths to the existing catalogs for the executable and
+			// native language name, by decreasing priority. Files whose
+			// attributes show they are for another executable or, unless
+			// it is 0, another fingerprint are left out.
+			// probes is increased by the number of files and folders looked
+			// up for that: none when the catalog was looked up before, and
+			// otherwise up to two per folder and the executable, plus those
+			// needed to start watching the folders the first time.
+		void GetNativeName(const char* code, BString& name);
+			// same as BLanguage::GetNativeName(), remembered for each code
+		void Invalidate();
+			// may be called from any thread
+
+	private:
+		struct Catalog {
+			BString		signature;
+			BString		language;
+				// native name, as in the folder name
+			BString		path;
+		};
+
+		class Watcher;
+
+		static void _GetMimeSignature(const entry_ref& owner,
+			BString& signature);
+		bool _StartWatching(const std::vector<BString>& folders,
+			int32& probes);
+		bool _WatchFolder(const BString& path, bool& exists,
+			int32& probes);
+		bool _Watch(int fd);
+		void _Rebuild(const std::vector<BString>& folders);
+		bool _ScanLanguages(const BString& path);
+		bool _ScanCatalogs(const BString& path, const char* language);
+		const char* _LanguageCode(const BString& nativeName);
+
+		BLocker						fLock;
+		BString						fExtension;
+		Watcher*					fWatcher;
+		bool						fWatching;
+			// whether the Catalogs/ folders are watched
+		bool						fValid;
+		std::vector<BString>		fRoots;
+		std::vector<bool>			fRootExists;
+		std::vector<Catalog>		fCatalogs;
+		std::map<BString, std::vector<BString> >	fLookups;
+			// paths by language and signature
+		bool						fHasLanguageCodes;
+		std::map<BString, BString>	fLanguageCodes;
+			// lowercase native language name to language code
+		std::map<BString, BString>	fNativeNames;
+			// language code to native name
+};
+
+
+} // namespace BPrivate
+
+
+#endif /* _CATALOG_INDEX_H_ */
@@ -0,0 +1,705 @@
+/*
+ * Copyright 2026, Adrien Destugues, pulkomandy@pulkomandy.tk.
+ * Distributed under the terms of the MIT License.
+ */
+
+/*	Measures the add-on itself, through AmigaCatalog::Instantiate() as the
+ *	locale kit calls it, so unlike catbench it only builds on Haiku.
+ *
+ *	Catalogs of random strings are written to the Catalogs/ folder next to
+ *	this program, where the add-on looks first, under its own name, and
+ *	removed afterwards. Results are printed as JSON, like catbench does.
+ */
+
+
+#include <errno.h>
+#include <fcntl.h>
+#include <libgen.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <sys/stat.h>
+#include <sys/wait.h>
+
+#include <algorithm>
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <Entry.h>
+#include <FindDirectory.h>
+#include <Language.h>
+#include <OS.h>
+#include <Path.h>
+
+#include "AmigaCatalog.h"
+#include "CatalogAttributes.h"
+#include "CTLGWriter.h"
+#include "RandomCatalog.h"
+
+
+using BPrivate::AmigaCatalog;
+using BPrivate::CTLGWriter;
+using BPrivate::generate_random_catalog;
+using BPrivate::RandomCatalogShape;
+using BPrivate::write_catalog_attributes;
+
+
+// As many languages as the locale kit may ask for when going through the
+// preferred languages of a user
+static const char* const kLanguages[] = {
+	"en", "de", "fr", "es", "it", "pt", "nl", "sv", "da", "nb",
+	"fi", "pl", "cs", "sk", "hu", "ro", "hr", "sl", "ru", "uk",
+	"be", "el", "tr", "lt", "lv", "et", "ja", "zh", "ko", "eo"
+};
+static const size_t kLanguageCount = sizeof(kLanguages)
+	/ sizeof(kLanguages[0]);
+
+static const int kMaxReloads = 64;
+	// the add-on doesn't reload a catalog more often than that
+
+
+struct Options {
+	RandomCatalogShape	shape;
+	int					repeats;
+	int64_t				windowWork;
+		// in nanoseconds
+	int					reloads;
+	size_t				threads;
+};
+
+
+/*	The catalogs written for the measurements, one per language, and what
+ *	Instantiate() needs to find them.
+ */
+struct Catalogs {
+	entry_ref					owner;
+	std::string					signature;
+		// the name of this program
+	std::string					folder;
+		// the Catalogs/ folder next to it
+	std::vector<std::string>	paths;
+	std::vector<BString>		nativeNames;
+	std::vector<std::string>	createdFolders;
+		// to remove, the deepest last
+};
+
+
+static int64_t
+now()
+{
+	struct timespec time;
+	clock_gettime(CLOCK_MONOTONIC, &time);
+	return (int64_t)time.tv_sec * 1000000000 + time.tv_nsec;
+}
+
+
+static std::string
+json_times(const char* name, std::vector<int64_t> times)
+{
+	std::sort(times.begin(), times.end());
+	char object[256];
+	snprintf(object, sizeof(object), "\"%s\": {\"min\": %lld, "
+		"\"median\": %lld, \"max\": %lld}", name, (long long)times.front(),
+		(long long)times[times.size() / 2], (long long)times.back());
+	return object;
+}
+
+
+static bool
+make_folder(Catalogs& catalogs, const std::string& path)
+{
+	if (mkdir(path.c_str(), 0755) == 0) {
+		catalogs.createdFolders.push_back(path);
+		return true;
+	}
+	struct stat st;
+	return errno == EEXIST && stat(path.c_str(), &st) == 0
+		&& S_ISDIR(st.st_mode);
+}
+
+
+static void
+remove_catalogs(Catalogs& catalogs)
+{
+	for (size_t i = 0; i < catalogs.paths.size(); i++)
+		unlink(catalogs.paths[i].c_str());
+	for (size_t i = catalogs.createdFolders.size(); i-- > 0;)
+		rmdir(catalogs.createdFolders[i].c_str());
+
+	catalogs.paths.clear();
+	catalogs.createdFolders.clear();
+}
+
+
+/*!	Writes a catalog of the given shape for each of the first \a count
+	languages, in the folder of its native name, as the add-on expects.
+*/
+static bool
+write_catalogs(Catalogs& catalogs, const RandomCatalogShape& shape,
+	size_t count)
+{
+	image_info info;
+	int32 cookie = 0;
+	if (get_next_image_info(B_CURRENT_TEAM, &cookie, &info) != B_OK
+		|| get_ref_for_path(info.name, &catalogs.owner) != B_OK)
+		return false;
+
+	std::vector<char> path(info.name, info.name + strlen(info.name) + 1);
+	catalogs.signature = basename(&path[0]);
+	path.assign(info.name, info.name + strlen(info.name) + 1);
+	catalogs.folder = std::string(dirname(&path[0])) + "/Catalogs";
+	if (!make_folder(catalogs, catalogs.folder))
+		return false;
+
+	for (size_t i = 0; i < count; i++) {
+		BString nativeName;
+		if (BLanguage(kLanguages[i]).GetNativeName(nativeName) != B_OK)
+			return false;
+
+		std::string folder = catalogs.folder + "/" + nativeName.String();
+		if (!make_folder(catalogs, folder))
+			return false;
+
+		RandomCatalogShape languageShape = shape;
+		languageShape.seed = shape.seed + i;
+		std::vector<uint8_t> buffer;
+		uint32_t fingerprint;
+		if (generate_random_catalog(languageShape, catalogs.signature.c_str(),
+				nativeName.String(), buffer, fingerprint) != 0)
+			return false;
+
+		std::string catalogPath = folder + "/" + catalogs.signature
+			+ ".catalog";
+		int fd = open(catalogPath.c_str(), O_WRONLY | O_CREAT | O_TRUNC,
+			0644);
+		if (fd < 0)
+			return false;
+		catalogs.paths.push_back(catalogPath);
+		catalogs.nativeNames.push_back(nativeName);
+
+		ssize_t written = write(fd, &buffer[0], buffer.size());
+		write_catalog_attributes(fd, catalogs.signature.c_str(),
+			nativeName.String(), fingerprint);
+		close(fd);
+		if (written != (ssize_t)buffer.size())
+			return false;
+	}
+	return true;
+}
+
+
+/*!	What every instantiation used to do before the answers were kept for the
+	whole process: find the folder of the executable and the system ones,
+	and the native name of the language.
+*/
+static void
+resolve_uncached(const char* language)
+{
+	image_info info;
+	int32 cookie = 0;
+	get_next_image_info(B_CURRENT_TEAM, &cookie, &info);
+
+	BPath path;
+	find_directory(B_USER_ETC_DIRECTORY, &path);
+	find_directory(B_SYSTEM_ETC_DIRECTORY, &path);
+
+	BString nativeName;
+	BLanguage(language).GetNativeName(nativeName);
+}
+
+
+/*!	Instantiates the catalog of each language in turn, the given number of
+	times, and compares that with just loading the same files, and with what
+	is now only resolved once per process.
+*/
+static bool
+run_instantiate(const Catalogs& catalogs, const Options& options,
+	std::string& results)
+{
+	// The first one also finds the catalog folders and builds the index
+	int64_t start = now();
+	BCatalogData* catalog = AmigaCatalog::Instantiate(catalogs.owner,
+		kLanguages[0], 0);
+	int64_t first = now() - start;
+	if (catalog == NULL)
+		return false;
+	delete catalog;
+
+	std::vector<int64_t> instantiateTimes;
+	std::vector<int64_t> loadTimes;
+	std::vector<int64_t> uncachedTimes;
+	for (int run = 0; run < options.repeats; run++) {
+		for (size_t i = 0; i < kLanguageCount; i++) {
+			start = now();
+			catalog = AmigaCatalog::Instantiate(catalogs.owner, kLanguages[i],
+				0);
+			instantiateTimes.push_back(now() - start);
+			if (catalog == NULL)
+				return false;
+			delete catalog;
+
+			start = now();
+			AmigaCatalog* loaded = new AmigaCatalog("",
+				catalogs.signature.c_str(), kLanguages[i]);
+			status_t status = loaded->ReadFromFile(catalogs.paths[i].c_str());
+			if (status == B_OK)
+				status = loaded->Freeze();
+			loadTimes.push_back(now() - start);
+			delete loaded;
+			if (status != B_OK)
+				return false;
+
+			start = now();
+			resolve_uncached(kLanguages[i]);
+			uncachedTimes.push_back(now() - start);
+		}
+	}
+
+	char object[256];
+	snprintf(object, sizeof(object), "{\"languages\": %zu, "
+		"\"strings\": %zu, \"firstInstantiateNanoseconds\": %lld, ",
+		kLanguageCount, options.shape.count, (long long)first);
+	results = object;
+	results += json_times("instantiateNanoseconds", instantiateTimes) + ", ";
+	results += json_times("loadNanoseconds", loadTimes) + ", ";
+	results += json_times("uncachedLookupsNanoseconds", uncachedTimes) + "}";
+	return true;
+}
+
+
+/*!	What an application does when it starts: it instantiates its catalog,
+	builds its first window, which takes \a options.windowWork, and shows it
+	once it has the translation of its title. Then it gets the strings of
+	its menus and views. Runs in a process of its own, so the options of the
+	add-on can be set, and writes the time of each step as a JSON object.
+*/
+static bool
+trace_startup(const Catalogs& catalogs, const Options& options, bool async,
+	FILE* output)
+{
+	setenv("AMIGA_CATALOG_OPTIONS", async ? "async" : "", 1);
+
+	int64_t start = now();
+	BCatalogData* catalog = AmigaCatalog::Instantiate(catalogs.owner,
+		kLanguages[0], 0);
+	int64_t instantiated = now() - start;
+	if (catalog == NULL)
+		return false;
+
+	// Nothing in the window depends on the catalog until its title
+	while (now() - start < instantiated + options.windowWork)
+		;
+	bool hasTitle = catalog->GetString((uint32)0) != NULL;
+	int64_t firstWindow = now() - start;
+
+	size_t missing = 0;
+	for (size_t id = 0; id < options.shape.count; id++) {
+		if (catalog->GetString((uint32)id) == NULL)
+			missing++;
+	}
+	int64_t allStrings = now() - start;
+	delete catalog;
+
+	fprintf(output, "{\"mode\": \"%s\", \"instantiateNanoseconds\": %lld, "
+		"\"firstWindowNanoseconds\": %lld, \"allStringsNanoseconds\": %lld, "
+		"\"missing\": %zu}", async ? "async" : "sync",
+		(long long)instantiated, (long long)firstWindow,
+		(long long)allStrings, missing);
+	return hasTitle;
+}
+
+
+/*!	Runs trace_startup() in a child process and appends its JSON object to
+	\a results. Unless \a cached, the catalog is touched first, so it has to
+	be read again instead of coming from the cache, as after an update.
+*/
+static bool
+run_startup(const Catalogs& catalogs, const Options& options, bool async,
+	bool cached, std::string& results)
+{
+	if (!cached) {
+		struct stat st;
+		if (stat(catalogs.paths[0].c_str(), &st) != 0)
+			return false;
+		struct timespec times[2];
+		times[0].tv_sec = times[1].tv_sec = st.st_mtime + 1;
+		times[0].tv_nsec = times[1].tv_nsec = 0;
+		if (utimensat(AT_FDCWD, catalogs.paths[0].c_str(), times, 0) != 0)
+			return false;
+	}
+
+	int pipeFDs[2];
+	if (pipe(pipeFDs) != 0)
+		return false;
+
+	fflush(NULL);
+	pid_t child = fork();
+	if (child < 0) {
+		close(pipeFDs[0]);
+		close(pipeFDs[1]);
+		return false;
+	}
+	if (child == 0) {
+		close(pipeFDs[0]);
+		FILE* output = fdopen(pipeFDs[1], "w");
+		bool success = output != NULL
+			&& trace_startup(catalogs, options, async, output);
+		if (output != NULL)
+			fclose(output);
+		_exit(success ? 0 : 1);
+	}
+
+	close(pipeFDs[1]);
+	std::string object;
+	char buffer[1024];
+	ssize_t bytesRead;
+	while ((bytesRead = read(pipeFDs[0], buffer, sizeof(buffer))) > 0)
+		object.append(buffer, bytesRead);
+	close(pipeFDs[0]);
+
+	int status;
+	if (waitpid(child, &status, 0) != child || !WIFEXITED(status)
+		|| WEXITSTATUS(status) != 0 || object.empty())
+		return false;
+
+	if (!results.empty())
+		results += ",\n\t\t";
+	results += object.substr(0, object.size() - 1) + ", \"cached\": "
+		+ (cached ? "true}" : "false}");
+	return true;
+}
+
+
+/*!	Replaces the catalog of the first language with one where each string
+	tells its ID and the generation it belongs to. It is written to another
+	file first, then renamed over the catalog, as editors do.
+*/
+static bool
+write_generation(const Catalogs& catalogs, size_t count, uint32 generation)
+{
+	CTLGWriter writer(catalogs.signature.c_str(),
+		catalogs.nativeNames[0].String());
+	std::vector<std::string> strings(count);
+	for (size_t id = 0; id < count; id++) {
+		char string[64];
+		snprintf(string, sizeof(string), "%" B_PRIu32 " %zu reloaded string",
+			generation, id);
+		strings[id] = string;
+		if (!writer.AddString(id, strings[id].data(), strings[id].size()))
+			return false;
+	}
+
+	std::vector<uint8_t> buffer;
+	if (!writer.Flatten(buffer))
+		return false;
+
+	std::string temporary = catalogs.paths[0] + ".new";
+	int fd = open(temporary.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+	if (fd < 0)
+		return false;
+	ssize_t written = write(fd, &buffer[0], buffer.size());
+	write_catalog_attributes(fd, catalogs.signature.c_str(),
+		catalogs.nativeNames[0].String(), writer.Fingerprint());
+	close(fd);
+
+	if (written != (ssize_t)buffer.size()
+		|| rename(temporary.c_str(), catalogs.paths[0].c_str()) != 0) {
+		unlink(temporary.c_str());
+		return false;
+	}
+	return true;
+}
+
+
+/*	Latencies of the lookups of one thread, in buckets of 8 ns up to about
+ *	131 us, and everything slower in the last one. Each one is on cache lines
+ *	of its own, so the threads don't slow each other down.
+ */
+struct alignas(64) LatencyHistogram {
+	static const size_t kBucketCount = 16384;
+	static const int64_t kBucketSize = 8;
+
+	std::vector<uint64_t>	buckets;
+	int64_t					max;
+	uint64_t				lookups;
+	uint64_t				missing;
+	uint64_t				torn;
+		// strings from an older generation than one seen before, or with
+		// the wrong ID
+	uint32					lastGeneration;
+
+	LatencyHistogram()
+		:
+		buckets(kBucketCount, 0),
+		max(0),
+		lookups(0),
+		missing(0),
+		torn(0),
+		lastGeneration(0)
+	{
+	}
+
+	void Add(int64_t latency)
+	{
+		buckets[std::min((size_t)(latency / kBucketSize), kBucketCount - 1)]++;
+		max = std::max(max, latency);
+		lookups++;
+	}
+
+	void Merge(const LatencyHistogram& other)
+	{
+		for (size_t i = 0; i < kBucketCount; i++)
+			buckets[i] += other.buckets[i];
+		max = std::max(max, other.max);
+		lookups += other.lookups;
+		missing += other.missing;
+		torn += other.torn;
+	}
+
+	int64_t Percentile(double percent) const
+	{
+		uint64_t rank = (uint64_t)(lookups * percent / 100);
+		uint64_t seen = 0;
+		for (size_t i = 0; i < kBucketCount; i++) {
+			seen += buckets[i];
+			if (seen > rank)
+				return std::min((int64_t)(i + 1) * kBucketSize, max);
+		}
+		return max;
+	}
+};
+
+
+static void
+hammer_lookups(BCatalogData* catalog, size_t count, size_t first,
+	const std::atomic<bool>& stop, std::atomic<uint32>& newestGeneration,
+	LatencyHistogram& histogram)
+{
+	size_t id = first;
+	while (!stop.load(std::memory_order_relaxed)) {
+		int64_t start = now();
+		const char* string = catalog->GetString((uint32)id);
+		histogram.Add(now() - start);
+
+		uint32 generation;
+		size_t stringID;
+		if (string == NULL)
+			histogram.missing++;
+		else if (sscanf(string, "%" B_SCNu32 " %zu", &generation, &stringID)
+				!= 2 || stringID != id
+			|| generation < histogram.lastGeneration)
+			histogram.torn++;
+		else if (generation > histogram.lastGeneration) {
+			histogram.lastGeneration = generation;
+			uint32 newest = newestGeneration.load(std::memory_order_relaxed);
+			while (generation > newest
+				&& !newestGeneration.compare_exchange_weak(newest,
+					generation, std::memory_order_relaxed))
+				;
+		}
+
+		if (++id == count)
+			id = 0;
+	}
+}
+
+
+/*!	Looks strings up from several threads as fast as they can, while the
+	catalog file is replaced every 20 ms, with the reload option. Reports
+	the latency percentiles of all lookups, and whether any of them saw a
+	string from an older generation after a newer one.
+*/
+static bool
+run_reload(const Catalogs& catalogs, const Options& options,
+	std::string& results)
+{
+	setenv("AMIGA_CATALOG_OPTIONS", "reload", 1);
+	size_t count = std::max(options.shape.count, (size_t)1);
+	if (!write_generation(catalogs, count, 0))
+		return false;
+
+	BCatalogData* catalog = AmigaCatalog::Instantiate(catalogs.owner,
+		kLanguages[0], 0);
+	if (catalog == NULL)
+		return false;
+
+	std::atomic<bool> stop(false);
+	std::atomic<uint32> newestGeneration(0);
+	std::vector<LatencyHistogram> histograms(options.threads);
+	std::vector<std::thread> threads;
+	for (size_t i = 0; i < options.threads; i++) {
+		threads.emplace_back(hammer_lookups, catalog, count,
+			count * i / options.threads, std::cref(stop),
+			std::ref(newestGeneration), std::ref(histograms[i]));
+	}
+
+	bool written = true;
+	int64_t start = now();
+	for (int generation = 1; generation <= options.reloads && written;
+			generation++) {
+		snooze(20000);
+		written = write_generation(catalogs, count, generation);
+	}
+
+	// Give the last reload some time to be published
+	for (int i = 0; i < 100 && newestGeneration.load() < (uint32)options.reloads;
+			i++)
+		snooze(10000);
+	int64_t elapsed = now() - start;
+
+	stop.store(true);
+	for (size_t i = 0; i < threads.size(); i++)
+		threads[i].join();
+	delete catalog;
+	if (!written)
+		return false;
+
+	LatencyHistogram total;
+	for (size_t i = 0; i < histograms.size(); i++)
+		total.Merge(histograms[i]);
+
+	char object[512];
+	snprintf(object, sizeof(object), "{\"threads\": %zu, \"strings\": %zu, "
+		"\"reloads\": %d, \"newestGenerationSeen\": %" B_PRIu32 ", "
+		"\"lookups\": %" B_PRIu64 ", \"lookupsPerSecond\": %.0f, "
+		"\"missing\": %" B_PRIu64 ", \"torn\": %" B_PRIu64 ", "
+		"\"latencyNanoseconds\": {\"p50\": %lld, \"p90\": %lld, "
+		"\"p99\": %lld, \"p99.9\": %lld, \"p99.99\": %lld, "
+		"\"max\": %lld}}", options.threads, count, options.reloads,
+		newestGeneration.load(), total.lookups,
+		elapsed > 0 ? total.lookups * 1e9 / elapsed : 0.0, total.missing,
+		total.torn, (long long)total.Percentile(50),
+		(long long)total.Percentile(90), (long long)total.Percentile(99),
+		(long long)total.Percentile(99.9), (long long)total.Percentile(99.99),
+		(long long)total.max);
+	results = object;
+	return total.torn == 0 && total.missing == 0;
+}
+
+
+static void
+usage()
+{
+	fprintf(stderr, "usage: catload [-n <strings>] [-r <repeats>] -i\n"
+		"       catload [-n <strings>] [-r <repeats>] [-w <window work>] -a\n"
+		"       catload [-n <strings>] [-t <threads>] [-R <reloads>]\n"
+		"\n"
+		"With -i, the catalog of each of %zu languages is instantiated in "
+		"turn.\n"
+		"With -a, the time until an application showing its first window "
+		"has its\n"
+		"title is traced, with and without the async option. Building the "
+		"window\n"
+		"takes the given number of microseconds, 20000 by default.\n"
+		"With -R, threads look strings up while the catalog is replaced "
+		"the given\n"
+		"number of times, and the latency of the lookups is reported.\n",
+		kLanguageCount);
+	exit(1);
+}
+
+
+static unsigned long
+parse_number(const char* string)
+{
+	char* end;
+	unsigned long value = strtoul(string, &end, 10);
+	if (end == string || *end != '\0')
+		usage();
+	return value;
+}
+
+
+int
+main(int argc, char** argv)
+{
+	Options options;
+	options.repeats = 10;
+	options.windowWork = 20000000;
+	options.reloads = 0;
+	options.threads = std::max(std::thread::hardware_concurrency(), 1u);
+	bool instantiate = false;
+	bool startup = false;
+
+	int option;
+	while ((option = getopt(argc, argv, "n:r:w:t:R:ia")) != -1) {
+		switch (option) {
+			case 'n':
+				options.shape.count = parse_number(optarg);
+				break;
+			case 'r':
+				options.repeats = parse_number(optarg);
+				if (options.repeats <= 0)
+					usage();
+				break;
+			case 'w':
+				options.windowWork = (int64_t)parse_number(optarg) * 1000;
+				break;
+			case 't':
+				options.threads = parse_number(optarg);
+				if (options.threads == 0)
+					usage();
+				break;
+			case 'R':
+				options.reloads = parse_number(optarg);
+				if (options.reloads <= 0 || options.reloads > kMaxReloads)
+					usage();
+				break;
+			case 'i':
+				instantiate = true;
+				break;
+			case 'a':
+				startup = true;
+				break;
+			default:
+				usage();
+		}
+	}
+	bool reload = options.reloads > 0;
+	if (optind != argc || instantiate + startup + reload != 1)
+		usage();
+
+	Catalogs catalogs;
+	if (!write_catalogs(catalogs, options.shape,
+			instantiate ? kLanguageCount : 1)) {
+		fprintf(stderr, "catload: could not write the catalogs next to the "
+			"program: %s\n", strerror(errno));
+		remove_catalogs(catalogs);
+		return 1;
+	}
+
+	std::string results;
+	bool success;
+	if (instantiate)
+		success = run_instantiate(catalogs, options, results);
+	else if (reload)
+		success = run_reload(catalogs, options, results);
+	else {
+		success = true;
+		for (int run = 0; run < options.repeats && success; run++) {
+			for (int mode = 0; mode < 4 && success; mode++) {
+				success = run_startup(catalogs, options, (mode & 1) != 0,
+					(mode & 2) != 0, results);
+			}
+		}
+	}
+	remove_catalogs(catalogs);
+	if (reload && !results.empty())
+		printf("{\n\t\"reload\": %s\n}\n", results.c_str());
+	if (!success) {
+		fprintf(stderr, reload ? "catload: lookups failed during reloads\n"
+			: "catload: instantiating a catalog failed\n");
+		return 1;
+	}
+
+	if (instantiate)
+		printf("{\n\t\"instantiate\": %s\n}\n", results.c_str());
+	else if (!reload)
+		printf("{\n\t\"startup\": [\n\t\t%s\n\t]\n}\n", results.c_str());
+	return 0;
+}
@@ -0,0 +1,244 @@
+/*
+ * Copyright 2026, Adrien Destugues, pulkomandy@pulkomandy.tk.
+ * Distributed under the terms of the MIT License.
+ */
+
+#include "CatalogLoader.h"
+
+#include <errno.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "CharsetConversion.h"
+#include "CodePages.h"
+
+
+namespace {
+
+
+using BPrivate::IDStringTable;
+
+
+class Latin1Decoder : public IDStringTable::Decoder {
+	public:
+		size_t MaxDecodedLength(size_t length) const
+		{
+			// Converting from ISO-8859-1 at most doubles the size
+			return length * 2;
+		}
+
+		size_t Decode(const char* string, size_t length, char* target) const
+		{
+			return BPrivate::latin1_to_utf8(string, length, target);
+		}
+};
+
+
+class UTF8Decoder : public IDStringTable::Decoder {
+	public:
+		size_t MaxDecodedLength(size_t length) const
+		{
+			return length;
+		}
+
+		size_t Decode(const char* string, size_t length, char* target) const
+		{
+			memcpy(target, string, length);
+			return length;
+		}
+};
+
+
+class DefaultDecoder : public IDStringTable::Decoder {
+	public:
+		size_t MaxDecodedLength(size_t length) const
+		{
+			return length * 2;
+		}
+
+		size_t Decode(const char* string, size_t length, char* target) const
+		{
+			// Catalogs that don't tell their code set are usually
+			// ISO-8859-1, but newer ones are often UTF-8 already, which
+			// must not be converted a second time.
+			if (BPrivate::is_valid_utf8(string, length)) {
+				memcpy(target, string, length);
+				return length;
+			}
+			return BPrivate::latin1_to_utf8(string, length, target);
+		}
+};
+
+
+const Latin1Decoder sLatin1Decoder;
+const UTF8Decoder sUTF8Decoder;
+const DefaultDecoder sDefaultDecoder;
+
+
+} // namespace
+
+
+const BPrivate::IDStringTable::Decoder*
+BPrivate::code_set_decoder(uint32_t codeSet)
+{
+	if (codeSet == kCTLGCodeSetUTF8)
+		return &sUTF8Decoder;
+	if (codeSet == kCTLGCodeSetLatin1)
+		return &sLatin1Decoder;
+
+	const IDStringTable::Decoder* decoder = code_page_decoder(codeSet);
+	return decoder != NULL ? decoder : &sDefaultDecoder;
+}
+
+
+int
+BPrivate::read_mapped_catalog(const uint8_t* data, size_t size,
+	IDStringTable& strings, bool lazy, std::string& version,
+	std::string& language)
+{
+	strings.SetDecoder(&sDefaultDecoder);
+	strings.SetSource((const char*)data, lazy);
+
+	CTLGChunkIterator chunks(data, size);
+	CTLGChunk chunk;
+
+	while (chunks.Next(chunk)) {
+		const char* chunkData = (const char*)chunk.data;
+
+		switch(chunk.id) {
+			case 'FVER': // Version
+				version.assign(chunkData, strnlen(chunkData, chunk.size));
+				break;
+			case 'LANG': // Language
+				language.assign(chunkData, strnlen(chunkData, chunk.size));
+				break;
+
+			case 'STRS': // Catalog strings
+			{
+				// The iterator rejects entries running past the end of the
+				// chunk.
+				CTLGStringIterator iterator(chunk);
+				CTLGString string;
+
+				while (iterator.Next(string)) {
+					if (!strings.Add(string.id, string.string, string.length))
+						return ENOMEM;
+				}
+				if (!iterator.IsValid())
+					return EINVAL;
+				break;
+			}
+
+			case 'CSET': // Code set
+				// Decoding happens later, so it doesn't matter if this
+				// comes after the strings.
+				if (chunk.size >= 4)
+					strings.SetDecoder(code_set_decoder(
+						ctlg_read_uint32(chunk.data)));
+				break;
+
+			default:
+				break;
+		}
+	}
+	if (!chunks.IsValid())
+		return EINVAL;
+
+	return 0;
+}
+
+
+int
+BPrivate::read_streamed_catalog(int fd, IDStringTable& strings,
+	std::string& version, std::string& language, size_t windowSize)
+{
+	// Pipes can't be read twice, which is only needed for unusual files
+	off_t start = lseek(fd, 0, SEEK_CUR);
+
+	// The code set has to be known before the strings are converted. It
+	// comes first in all files we know of, otherwise the file is read a
+	// second time with the right decoder.
+	const IDStringTable::Decoder* decoder = &sDefaultDecoder;
+	for (int pass = 0; pass < 2; pass++) {
+		if (pass > 0 && (start < 0 || lseek(fd, start, SEEK_SET) != start))
+			return EINVAL;
+
+		IDStringTable table;
+		table.SetDecoder(decoder);
+		const IDStringTable::Decoder* fileDecoder = &sDefaultDecoder;
+		bool hasStrings = false;
+
+		CTLGStreamReader reader(fd, windowSize);
+		CTLGChunk chunk;
+
+		while (reader.NextChunk(chunk)) {
+			const char* chunkData = (const char*)chunk.data;
+
+			switch(chunk.id) {
+				case 'FVER': // Version
+					if (chunkData != NULL) {
+						version.assign(chunkData,
+							strnlen(chunkData, chunk.size));
+					}
+					break;
+				case 'LANG': // Language
+					if (chunkData != NULL) {
+						language.assign(chunkData,
+							strnlen(chunkData, chunk.size));
+					}
+					break;
+
+				case 'STRS': // Catalog strings
+				{
+					CTLGString string;
+					while (reader.NextString(string)) {
+						hasStrings = true;
+						if (!table.Add(string.id, string.string,
+								string.length))
+							return ENOMEM;
+					}
+					break;
+				}
+
+				case 'CSET': // Code set
+					if (chunkData != NULL && chunk.size >= 4) {
+						fileDecoder = code_set_decoder(
+							ctlg_read_uint32(chunk.data));
+					}
+					if (!hasStrings) {
+						decoder = fileDecoder;
+						table.SetDecoder(decoder);
+					}
+					break;
+
+				default:
+					break;
+			}
+		}
+		if (!reader.IsValid())
+			return EINVAL;
+
+		if (hasStrings && fileDecoder != decoder) {
+			decoder = fileDecoder;
+			continue;
+		}
+
+		strings.Swap(table);
+		break;
+	}
+
+	return 0;
+}
+
+
+bool
+BPrivate::add_table_strings(CTLGWriter& writer, const IDStringTable& strings)
+{
+	for (size_t i = 0; i < strings.CountItems(); i++) {
+		const char* string = strings.StringAt(i);
+		if (string == NULL
+			|| !writer.AddString(strings.IDAt(i), string, strlen(string)))
+			return false;
+	}
+	return true;
+}
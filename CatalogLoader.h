@@ -0,0 +1,63 @@
+/*
+ * Copyright 2026, Adrien Destugues, pulkomandy@pulkomandy.tk.
+ * Distributed under the terms of the MIT License.
+ */
+#ifndef _CATALOG_LOADER_H_
+#define _CATALOG_LOADER_H_
+
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <string>
+
+#include "CTLGReader.h"
+#include "CTLGWriter.h"
+#include "StringTable.h"
+
+
+/*	Reads the strings of a CTLG file into an IDStringTable, the way the
+ *	add-on loads catalogs, but without depending on any Haiku kit. The
+ *	version and language are only changed if the file has them. The caller
+ *	still has to Finish() the table.
+ *
+ *	The "X\0" menu shortcut prefix some strings have is not part of what is
+ *	looked up, so it is dropped while reading, and a catalog written back
+ *	from a table doesn't have it anymore.
+ *
+ *	Both functions return 0 on success, ENOMEM if there was not enough
+ *	memory, EINVAL if the file is not a valid catalog, or another errno
+ *	value if it couldn't be read.
+ */
+
+
+namespace BPrivate {
+
+
+const IDStringTable::Decoder* code_set_decoder(uint32_t codeSet);
+	// Returns the decoder for the strings of a catalog with the given CSET
+	// value. Unknown code sets, and 0 for files without a CSET chunk, get
+	// one that keeps valid UTF-8 as is and converts anything else from
+	// ISO-8859-1.
+
+int read_mapped_catalog(const uint8_t* data, size_t size,
+	IDStringTable& strings, bool lazy, std::string& version,
+	std::string& language);
+	// Walks the chunks of a file in memory in place. Only the position of
+	// each string is recorded, they are converted by Finish() or, for lazy
+	// tables, on first lookup, so the data must stay valid until then.
+int read_streamed_catalog(int fd, IDStringTable& strings,
+	std::string& version, std::string& language,
+	size_t windowSize = kCTLGDefaultWindowSize);
+	// Reads a file from its current position through a window of the given
+	// size, converting the strings as they arrive.
+
+bool add_table_strings(CTLGWriter& writer, const IDStringTable& strings);
+	// Adds all strings of a finished table, to write them back as the
+	// add-on does. Returns false if there was not enough memory.
+
+
+} // namespace BPrivate
+
+
+#endif /* _CATALOG_LOADER_H_ */
@@ -0,0 +1,128 @@
+/*
+ * Copyright 2026, Adrien Destugues, pulkomandy@pulkomandy.tk.
+ * Distributed under the terms of the MIT License.
+ */
+
+#include "CatalogWatcher.h"
+
+#include <Entry.h>
+#include <Message.h>
+#include <NodeMonitor.h>
+
+
+using BPrivate::CatalogWatcher;
+
+
+static const uint32 kMsgUpdate = 'cwUp';
+
+
+CatalogWatcher::CatalogWatcher(const char* path,
+	const std::function<void()>& changed)
+	:
+	BLooper("catalog watcher", B_LOW_PRIORITY),
+	fPath(path),
+	fChanged(changed),
+	fExists(false),
+	fChangePending(false)
+{
+}
+
+
+status_t
+CatalogWatcher::Start()
+{
+	BEntry entry(fPath.String());
+	BEntry parent;
+	node_ref directory;
+	status_t status = entry.GetParent(&parent);
+	if (status == B_OK)
+		status = parent.GetNodeRef(&directory);
+	if (status != B_OK)
+		return status;
+
+	Run();
+
+	status = watch_node(&directory, B_WATCH_DIRECTORY, this);
+	if (status == B_OK)
+		_WatchFile();
+	return status;
+}
+
+
+void
+CatalogWatcher::Stop()
+{
+	stop_watching(this);
+	if (Lock())
+		Quit();
+}
+
+
+void
+CatalogWatcher::Update()
+{
+	// Only write to the flag when it is set, so lookups calling this don't
+	// contend with each other
+	if (fChangePending.load(std::memory_order_relaxed)
+		&& fChangePending.exchange(false, std::memory_order_acquire))
+		PostMessage(kMsgUpdate);
+}
+
+
+void
+CatalogWatcher::MessageReceived(BMessage* message)
+{
+	if (message->what == kMsgUpdate) {
+		fChanged();
+		return;
+	}
+	if (message->what != B_NODE_MONITOR) {
+		BLooper::MessageReceived(message);
+		return;
+	}
+
+	struct stat st;
+	if (stat(fPath.String(), &st) != 0) {
+		// Being replaced, or removed. Keep the strings we have until a new
+		// file shows up.
+		fExists = false;
+		return;
+	}
+
+	if (fExists && st.st_dev == fStat.st_dev && st.st_ino == fStat.st_ino
+		&& st.st_mtim.tv_sec == fStat.st_mtim.tv_sec
+		&& st.st_mtim.tv_nsec == fStat.st_mtim.tv_nsec
+		&& st.st_size == fStat.st_size)
+		return;
+
+	if (!fExists || st.st_dev != fStat.st_dev || st.st_ino != fStat.st_ino) {
+		// Another file now has this name
+		if (fExists) {
+			node_ref node;
+			node.device = fStat.st_dev;
+			node.node = fStat.st_ino;
+			watch_node(&node, B_STOP_WATCHING, this);
+		}
+		_WatchFile();
+	} else
+		fStat = st;
+
+	fChangePending.store(true, std::memory_order_release);
+}
+
+
+/*!	Starts watching the file currently at fPath, and remembers its
+	attributes.
+*/
+bool
+CatalogWatcher::_WatchFile()
+{
+	fExists = stat(fPath.String(), &fStat) == 0;
+	if (!fExists)
+		return false;
+
+	node_ref node;
+	node.device = fStat.st_dev;
+	node.node = fStat.st_ino;
+	return watch_node(&node, B_WATCH_STAT, this) == B_OK;
+}
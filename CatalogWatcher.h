@@ -0,0 +1,60 @@
+/*
+ * Copyright 2026, Adrien Destugues, pulkomandy@pulkomandy.tk.
+ * Distributed under the terms of the MIT License.
+ */
+#ifndef _CATALOG_WATCHER_H_
+#define _CATALOG_WATCHER_H_
+
+
+#include <sys/stat.h>
+
+#include <atomic>
+#include <functional>
+
+#include <Looper.h>
+#include <String.h>
+
+
+namespace BPrivate {
+
+
+/*	Watches a catalog file with the node monitor. The file is watched
+ *	directly, for changes made in place, and through its directory, for when
+ *	it is replaced by another one. Events which leave the device, inode,
+ *	modification time and size of the file unchanged are ignored.
+ *
+ *	Changes are only noted. The function is called on the watcher thread
+ *	after Update() was called, if the file changed since the last call, so
+ *	any number of changes nobody looked at in between cost a single call.
+ *
+ *	Create it with new, call Start(), and Stop() instead of deleting it.
+ */
+class CatalogWatcher : public BLooper {
+	public:
+		CatalogWatcher(const char* path,
+			const std::function<void()>& changed);
+
+		status_t Start();
+		void Stop();
+
+		void Update();
+			// may be called from any thread, and only reads memory unless
+			// the file changed
+
+		virtual void MessageReceived(BMessage* message);
+
+	private:
+		bool _WatchFile();
+
+		BString					fPath;
+		std::function<void()>	fChanged;
+		struct stat				fStat;
+		bool					fExists;
+		std::atomic<bool>		fChangePending;
+};
+
+
+} // namespace BPrivate
+
+
+#endif /* _CATALOG_WATCHER_H_ */
@@ -0,0 +1,200 @@
+/*
+ * Copyright 2026, Adrien Destugues, pulkomandy@pulkomandy.tk.
+ * Distributed under the terms of the MIT License.
+ */
+
+#include "CharsetConversion.h"
+
+#include <stdint.h>
+#include <string.h>
+
+#if defined(__AVX2__) || defined(__SSE2__)
+#	include <immintrin.h>
+#endif
+
+
+/*	Most catalog strings are plain ASCII, even in translations: only a few
+ *	characters need to be expanded to two bytes. The conversion thus looks
+ *	for the high bit in whole blocks of the source, copies blocks without it
+ *	as they are, and only expands the bytes of the other blocks one by one.
+ */
+
+
+static inline size_t
+expand_latin1(const uint8_t* source, size_t length, uint8_t* target)
+{
+	uint8_t* start = target;
+	for (size_t i = 0; i < length; i++) {
+		uint8_t c = source[i];
+		if (c < 0x80)
+			*target++ = c;
+		else {
+			*target++ = 0xc0 | (c >> 6);
+			*target++ = 0x80 | (c & 0x3f);
+		}
+	}
+	return target - start;
+}
+
+
+size_t
+BPrivate::latin1_to_utf8(const char* _source, size_t length, char* _target)
+{
+	const uint8_t* source = (const uint8_t*)_source;
+	const uint8_t* end = source + length;
+	uint8_t* target = (uint8_t*)_target;
+	uint8_t* start = target;
+
+#if defined(__AVX2__)
+	while (end - source >= 32) {
+		__m256i block = _mm256_loadu_si256((const __m256i*)source);
+		if (_mm256_movemask_epi8(block) == 0) {
+			_mm256_storeu_si256((__m256i*)target, block);
+			target += 32;
+		} else
+			target += expand_latin1(source, 32, target);
+		source += 32;
+	}
+#endif
+
+#if defined(__SSE2__)
+	while (end - source >= 16) {
+		__m128i block = _mm_loadu_si128((const __m128i*)source);
+		if (_mm_movemask_epi8(block) == 0) {
+			_mm_storeu_si128((__m128i*)target, block);
+			target += 16;
+		} else
+			target += expand_latin1(source, 16, target);
+		source += 16;
+	}
+#endif
+
+	while (end - source >= 8) {
+		uint64_t block;
+		memcpy(&block, source, sizeof(block));
+		if ((block & UINT64_C(0x8080808080808080)) == 0) {
+			memcpy(target, &block, sizeof(block));
+			target += 8;
+		} else
+			target += expand_latin1(source, 8, target);
+		source += 8;
+	}
+
+	target += expand_latin1(source, end - source, target);
+	return target - start;
+}
+
+
+/*	Validation uses the same idea: blocks without the high bit are skipped
+ *	at once, and only the multi-byte sequences are checked one by one.
+ */
+static inline const uint8_t*
+skip_ascii(const uint8_t* source, const uint8_t* end)
+{
+#if defined(__AVX2__)
+	while (end - source >= 32) {
+		__m256i block = _mm256_loadu_si256((const __m256i*)source);
+		if (_mm256_movemask_epi8(block) != 0)
+			return source;
+		source += 32;
+	}
+#endif
+
+#if defined(__SSE2__)
+	while (end - source >= 16) {
+		__m128i block = _mm_loadu_si128((const __m128i*)source);
+		if (_mm_movemask_epi8(block) != 0)
+			return source;
+		source += 16;
+	}
+#endif
+
+	while (end - source >= 8) {
+		uint64_t block;
+		memcpy(&block, source, sizeof(block));
+		if ((block & UINT64_C(0x8080808080808080)) != 0)
+			return source;
+		source += 8;
+	}
+	return source;
+}
+
+
+bool
+BPrivate::is_valid_utf8(const char* _source, size_t length)
+{
+	const uint8_t* source = (const uint8_t*)_source;
+	const uint8_t* end = source + length;
+
+	while (true) {
+		source = skip_ascii(source, end);
+		if (source == end)
+			return true;
+
+		uint8_t c = *source;
+		if (c < 0x80) {
+			source++;
+			continue;
+		}
+
+		// The range of the second byte also rules out overlong sequences,
+		// surrogates and code points past U+10FFFF.
+		size_t count;
+		uint8_t low = 0x80;
+		uint8_t high = 0xbf;
+		if (c < 0xc2)
+			return false;
+		else if (c < 0xe0)
+			count = 1;
+		else if (c < 0xf0) {
+			count = 2;
+			if (c == 0xe0)
+				low = 0xa0;
+			else if (c == 0xed)
+				high = 0x9f;
+		} else if (c < 0xf5) {
+			count = 3;
+			if (c == 0xf0)
+				low = 0x90;
+			else if (c == 0xf4)
+				high = 0x8f;
+		} else
+			return false;
+
+		if ((size_t)(end - source) <= count
+			|| source[1] < low || source[1] > high)
+			return false;
+		for (size_t i = 2; i <= count; i++) {
+			if ((source[i] & 0xc0) != 0x80)
+				return false;
+		}
+		source += count + 1;
+	}
+}
+
+
+bool
+BPrivate::utf8_to_latin1(const char* _source, size_t length, char* _target,
+	size_t& targetLength)
+{
+	const uint8_t* source = (const uint8_t*)_source;
+	const uint8_t* end = source + length;
+	uint8_t* target = (uint8_t*)_target;
+	targetLength = 0;
+
+	while (source < end) {
+		uint8_t c = *source++;
+		if (c >= 0x80) {
+			// Only U+0080 to U+00FF fit, they are encoded as C2 or C3
+			// followed by one continuation byte.
+			if ((c & 0xfe) != 0xc2 || source == end
+				|| (*source & 0xc0) != 0x80)
+				return false;
+			c = (c << 6) | (*source++ & 0x3f);
+		}
+		if (target != NULL)
+			target[targetLength] = c;
+		targetLength++;
+	}
+	return true;
+}
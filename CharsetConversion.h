@@ -0,0 +1,35 @@
+/*
+ * Copyright 2026, Adrien Destugues, pulkomandy@pulkomandy.tk.
+ * Distributed under the terms of the MIT License.
+ */
+#ifndef _CHARSET_CONVERSION_H_
+#define _CHARSET_CONVERSION_H_
+
+
+#include <stddef.h>
+
+
+namespace BPrivate {
+
+
+size_t latin1_to_utf8(const char* source, size_t length, char* target);
+	// Converts an ISO-8859-1 string to UTF-8 and returns the length of the
+	// result. The target must have room for twice the source length, and is
+	// not NULL terminated.
+
+bool is_valid_utf8(const char* source, size_t length);
+	// Checks that a string is well formed UTF-8: no stray continuation
+	// bytes, truncated or overlong sequences, surrogates, or code points
+	// past U+10FFFF.
+
+bool utf8_to_latin1(const char* source, size_t length, char* target,
+	size_t& targetLength);
+	// Converts a UTF-8 string to ISO-8859-1. Returns false if the string is
+	// not valid UTF-8, or has characters that ISO-8859-1 doesn't have. The
+	// target may be NULL to only check the string and compute the length.
+
+
+} // namespace BPrivate
+
+
+#endif /* _CHARSET_CONVERSION_H_ */
@@ -0,0 +1,727 @@
+/*
+ * Copyright 2026, Adrien Destugues, pulkomandy@pulkomandy.tk.
+ * Distributed under the terms of the MIT License.
+ */
+
+#include "CodePages.h"
+
+
+using BPrivate::IDStringTable;
+
+
+/*	UTF-8 encoding of the bytes 0x80 to 0xff in each code page, generated
+ *	from the Unicode mapping tables. Bytes a code page leaves undefined map
+ *	to U+FFFD. The lower half is ASCII in all of them.
+ */
+typedef char CodePageTable[128][4];
+
+
+
+// ISO-8859-2, Central European
+static const CodePageTable kISO88592 = {
+	"\xc2\x80", "\xc2\x81", "\xc2\x82", "\xc2\x83",
+	"\xc2\x84", "\xc2\x85", "\xc2\x86", "\xc2\x87",
+	"\xc2\x88", "\xc2\x89", "\xc2\x8a", "\xc2\x8b",
+	"\xc2\x8c", "\xc2\x8d", "\xc2\x8e", "\xc2\x8f",
+	"\xc2\x90", "\xc2\x91", "\xc2\x92", "\xc2\x93",
+	"\xc2\x94", "\xc2\x95", "\xc2\x96", "\xc2\x97",
+	"\xc2\x98", "\xc2\x99", "\xc2\x9a", "\xc2\x9b",
+	"\xc2\x9c", "\xc2\x9d", "\xc2\x9e", "\xc2\x9f",
+	"\xc2\xa0", "\xc4\x84", "\xcb\x98", "\xc5\x81",
+	"\xc2\xa4", "\xc4\xbd", "\xc5\x9a", "\xc2\xa7",
+	"\xc2\xa8", "\xc5\xa0", "\xc5\x9e", "\xc5\xa4",
+	"\xc5\xb9", "\xc2\xad", "\xc5\xbd", "\xc5\xbb",
+	"\xc2\xb0", "\xc4\x85", "\xcb\x9b", "\xc5\x82",
+	"\xc2\xb4", "\xc4\xbe", "\xc5\x9b", "\xcb\x87",
+	"\xc2\xb8", "\xc5\xa1", "\xc5\x9f", "\xc5\xa5",
+	"\xc5\xba", "\xcb\x9d", "\xc5\xbe", "\xc5\xbc",
+	"\xc5\x94", "\xc3\x81", "\xc3\x82", "\xc4\x82",
+	"\xc3\x84", "\xc4\xb9", "\xc4\x86", "\xc3\x87",
+	"\xc4\x8c", "\xc3\x89", "\xc4\x98", "\xc3\x8b",
+	"\xc4\x9a", "\xc3\x8d", "\xc3\x8e", "\xc4\x8e",
+	"\xc4\x90", "\xc5\x83", "\xc5\x87", "\xc3\x93",
+	"\xc3\x94", "\xc5\x90", "\xc3\x96", "\xc3\x97",
+	"\xc5\x98", "\xc5\xae", "\xc3\x9a", "\xc5\xb0",
+	"\xc3\x9c", "\xc3\x9d", "\xc5\xa2", "\xc3\x9f",
+	"\xc5\x95", "\xc3\xa1", "\xc3\xa2", "\xc4\x83",
+	"\xc3\xa4", "\xc4\xba", "\xc4\x87", "\xc3\xa7",
+	"\xc4\x8d", "\xc3\xa9", "\xc4\x99", "\xc3\xab",
+	"\xc4\x9b", "\xc3\xad", "\xc3\xae", "\xc4\x8f",
+	"\xc4\x91", "\xc5\x84", "\xc5\x88", "\xc3\xb3",
+	"\xc3\xb4", "\xc5\x91", "\xc3\xb6", "\xc3\xb7",
+	"\xc5\x99", "\xc5\xaf", "\xc3\xba", "\xc5\xb1",
+	"\xc3\xbc", "\xc3\xbd", "\xc5\xa3", "\xcb\x99"
+};
+
+
+// ISO-8859-3, South European
+static const CodePageTable kISO88593 = {
+	"\xc2\x80", "\xc2\x81", "\xc2\x82", "\xc2\x83",
+	"\xc2\x84", "\xc2\x85", "\xc2\x86", "\xc2\x87",
+	"\xc2\x88", "\xc2\x89", "\xc2\x8a", "\xc2\x8b",
+	"\xc2\x8c", "\xc2\x8d", "\xc2\x8e", "\xc2\x8f",
+	"\xc2\x90", "\xc2\x91", "\xc2\x92", "\xc2\x93",
+	"\xc2\x94", "\xc2\x95", "\xc2\x96", "\xc2\x97",
+	"\xc2\x98", "\xc2\x99", "\xc2\x9a", "\xc2\x9b",
+	"\xc2\x9c", "\xc2\x9d", "\xc2\x9e", "\xc2\x9f",
+	"\xc2\xa0", "\xc4\xa6", "\xcb\x98", "\xc2\xa3",
+	"\xc2\xa4", "\xef\xbf\xbd", "\xc4\xa4", "\xc2\xa7",
+	"\xc2\xa8", "\xc4\xb0", "\xc5\x9e", "\xc4\x9e",
+	"\xc4\xb4", "\xc2\xad", "\xef\xbf\xbd", "\xc5\xbb",
+	"\xc2\xb0", "\xc4\xa7", "\xc2\xb2", "\xc2\xb3",
+	"\xc2\xb4", "\xc2\xb5", "\xc4\xa5", "\xc2\xb7",
+	"\xc2\xb8", "\xc4\xb1", "\xc5\x9f", "\xc4\x9f",
+	"\xc4\xb5", "\xc2\xbd", "\xef\xbf\xbd", "\xc5\xbc",
+	"\xc3\x80", "\xc3\x81", "\xc3\x82", "\xef\xbf\xbd",
+	"\xc3\x84", "\xc4\x8a", "\xc4\x88", "\xc3\x87",
+	"\xc3\x88", "\xc3\x89", "\xc3\x8a", "\xc3\x8b",
+	"\xc3\x8c", "\xc3\x8d", "\xc3\x8e", "\xc3\x8f",
+	"\xef\xbf\xbd", "\xc3\x91", "\xc3\x92", "\xc3\x93",
+	"\xc3\x94", "\xc4\xa0", "\xc3\x96", "\xc3\x97",
+	"\xc4\x9c", "\xc3\x99", "\xc3\x9a", "\xc3\x9b",
+	"\xc3\x9c", "\xc5\xac", "\xc5\x9c", "\xc3\x9f",
+	"\xc3\xa0", "\xc3\xa1", "\xc3\xa2", "\xef\xbf\xbd",
+	"\xc3\xa4", "\xc4\x8b", "\xc4\x89", "\xc3\xa7",
+	"\xc3\xa8", "\xc3\xa9", "\xc3\xaa", "\xc3\xab",
+	"\xc3\xac", "\xc3\xad", "\xc3\xae", "\xc3\xaf",
+	"\xef\xbf\xbd", "\xc3\xb1", "\xc3\xb2", "\xc3\xb3",
+	"\xc3\xb4", "\xc4\xa1", "\xc3\xb6", "\xc3\xb7",
+	"\xc4\x9d", "\xc3\xb9", "\xc3\xba", "\xc3\xbb",
+	"\xc3\xbc", "\xc5\xad", "\xc5\x9d", "\xcb\x99"
+};
+
+
+// ISO-8859-4, North European
+static const CodePageTable kISO88594 = {
+	"\xc2\x80", "\xc2\x81", "\xc2\x82", "\xc2\x83",
+	"\xc2\x84", "\xc2\x85", "\xc2\x86", "\xc2\x87",
+	"\xc2\x88", "\xc2\x89", "\xc2\x8a", "\xc2\x8b",
+	"\xc2\x8c", "\xc2\x8d", "\xc2\x8e", "\xc2\x8f",
+	"\xc2\x90", "\xc2\x91", "\xc2\x92", "\xc2\x93",
+	"\xc2\x94", "\xc2\x95", "\xc2\x96", "\xc2\x97",
+	"\xc2\x98", "\xc2\x99", "\xc2\x9a", "\xc2\x9b",
+	"\xc2\x9c", "\xc2\x9d", "\xc2\x9e", "\xc2\x9f",
+	"\xc2\xa0", "\xc4\x84", "\xc4\xb8", "\xc5\x96",
+	"\xc2\xa4", "\xc4\xa8", "\xc4\xbb", "\xc2\xa7",
+	"\xc2\xa8", "\xc5\xa0", "\xc4\x92", "\xc4\xa2",
+	"\xc5\xa6", "\xc2\xad", "\xc5\xbd", "\xc2\xaf",
+	"\xc2\xb0", "\xc4\x85", "\xcb\x9b", "\xc5\x97",
+	"\xc2\xb4", "\xc4\xa9", "\xc4\xbc", "\xcb\x87",
+	"\xc2\xb8", "\xc5\xa1", "\xc4\x93", "\xc4\xa3",
+	"\xc5\xa7", "\xc5\x8a", "\xc5\xbe", "\xc5\x8b",
+	"\xc4\x80", "\xc3\x81", "\xc3\x82", "\xc3\x83",
+	"\xc3\x84", "\xc3\x85", "\xc3\x86", "\xc4\xae",
+	"\xc4\x8c", "\xc3\x89", "\xc4\x98", "\xc3\x8b",
+	"\xc4\x96", "\xc3\x8d", "\xc3\x8e", "\xc4\xaa",
+	"\xc4\x90", "\xc5\x85", "\xc5\x8c", "\xc4\xb6",
+	"\xc3\x94", "\xc3\x95", "\xc3\x96", "\xc3\x97",
+	"\xc3\x98", "\xc5\xb2", "\xc3\x9a", "\xc3\x9b",
+	"\xc3\x9c", "\xc5\xa8", "\xc5\xaa", "\xc3\x9f",
+	"\xc4\x81", "\xc3\xa1", "\xc3\xa2", "\xc3\xa3",
+	"\xc3\xa4", "\xc3\xa5", "\xc3\xa6", "\xc4\xaf",
+	"\xc4\x8d", "\xc3\xa9", "\xc4\x99", "\xc3\xab",
+	"\xc4\x97", "\xc3\xad", "\xc3\xae", "\xc4\xab",
+	"\xc4\x91", "\xc5\x86", "\xc5\x8d", "\xc4\xb7",
+	"\xc3\xb4", "\xc3\xb5", "\xc3\xb6", "\xc3\xb7",
+	"\xc3\xb8", "\xc5\xb3", "\xc3\xba", "\xc3\xbb",
+	"\xc3\xbc", "\xc5\xa9", "\xc5\xab", "\xcb\x99"
+};
+
+
+// ISO-8859-5, Cyrillic
+static const CodePageTable kISO88595 = {
+	"\xc2\x80", "\xc2\x81", "\xc2\x82", "\xc2\x83",
+	"\xc2\x84", "\xc2\x85", "\xc2\x86", "\xc2\x87",
+	"\xc2\x88", "\xc2\x89", "\xc2\x8a", "\xc2\x8b",
+	"\xc2\x8c", "\xc2\x8d", "\xc2\x8e", "\xc2\x8f",
+	"\xc2\x90", "\xc2\x91", "\xc2\x92", "\xc2\x93",
+	"\xc2\x94", "\xc2\x95", "\xc2\x96", "\xc2\x97",
+	"\xc2\x98", "\xc2\x99", "\xc2\x9a", "\xc2\x9b",
+	"\xc2\x9c", "\xc2\x9d", "\xc2\x9e", "\xc2\x9f",
+	"\xc2\xa0", "\xd0\x81", "\xd0\x82", "\xd0\x83",
+	"\xd0\x84", "\xd0\x85", "\xd0\x86", "\xd0\x87",
+	"\xd0\x88", "\xd0\x89", "\xd0\x8a", "\xd0\x8b",
+	"\xd0\x8c", "\xc2\xad", "\xd0\x8e", "\xd0\x8f",
+	"\xd0\x90", "\xd0\x91", "\xd0\x92", "\xd0\x93",
+	"\xd0\x94", "\xd0\x95", "\xd0\x96", "\xd0\x97",
+	"\xd0\x98", "\xd0\x99", "\xd0\x9a", "\xd0\x9b",
+	"\xd0\x9c", "\xd0\x9d", "\xd0\x9e", "\xd0\x9f",
+	"\xd0\xa0", "\xd0\xa1", "\xd0\xa2", "\xd0\xa3",
+	"\xd0\xa4", "\xd0\xa5", "\xd0\xa6", "\xd0\xa7",
+	"\xd0\xa8", "\xd0\xa9", "\xd0\xaa", "\xd0\xab",
+	"\xd0\xac", "\xd0\xad", "\xd0\xae", "\xd0\xaf",
+	"\xd0\xb0", "\xd0\xb1", "\xd0\xb2", "\xd0\xb3",
+	"\xd0\xb4", "\xd0\xb5", "\xd0\xb6", "\xd0\xb7",
+	"\xd0\xb8", "\xd0\xb9", "\xd0\xba", "\xd0\xbb",
+	"\xd0\xbc", "\xd0\xbd", "\xd0\xbe", "\xd0\xbf",
+	"\xd1\x80", "\xd1\x81", "\xd1\x82", "\xd1\x83",
+	"\xd1\x84", "\xd1\x85", "\xd1\x86", "\xd1\x87",
+	"\xd1\x88", "\xd1\x89", "\xd1\x8a", "\xd1\x8b",
+	"\xd1\x8c", "\xd1\x8d", "\xd1\x8e", "\xd1\x8f",
+	"\xe2\x84\x96", "\xd1\x91", "\xd1\x92", "\xd1\x93",
+	"\xd1\x94", "\xd1\x95", "\xd1\x96", "\xd1\x97",
+	"\xd1\x98", "\xd1\x99", "\xd1\x9a", "\xd1\x9b",
+	"\xd1\x9c", "\xc2\xa7", "\xd1\x9e", "\xd1\x9f"
+};
+
+
+// ISO-8859-7, Greek
+static const CodePageTable kISO88597 = {
+	"\xc2\x80", "\xc2\x81", "\xc2\x82", "\xc2\x83",
+	"\xc2\x84", "\xc2\x85", "\xc2\x86", "\xc2\x87",
+	"\xc2\x88", "\xc2\x89", "\xc2\x8a", "\xc2\x8b",
+	"\xc2\x8c", "\xc2\x8d", "\xc2\x8e", "\xc2\x8f",
+	"\xc2\x90", "\xc2\x91", "\xc2\x92", "\xc2\x93",
+	"\xc2\x94", "\xc2\x95", "\xc2\x96", "\xc2\x97",
+	"\xc2\x98", "\xc2\x99", "\xc2\x9a", "\xc2\x9b",
+	"\xc2\x9c", "\xc2\x9d", "\xc2\x9e", "\xc2\x9f",
+	"\xc2\xa0", "\xe2\x80\x98", "\xe2\x80\x99", "\xc2\xa3",
+	"\xe2\x82\xac", "\xe2\x82\xaf", "\xc2\xa6", "\xc2\xa7",
+	"\xc2\xa8", "\xc2\xa9", "\xcd\xba", "\xc2\xab",
+	"\xc2\xac", "\xc2\xad", "\xef\xbf\xbd", "\xe2\x80\x95",
+	"\xc2\xb0", "\xc2\xb1", "\xc2\xb2", "\xc2\xb3",
+	"\xce\x84", "\xce\x85", "\xce\x86", "\xc2\xb7",
+	"\xce\x88", "\xce\x89", "\xce\x8a", "\xc2\xbb",
+	"\xce\x8c", "\xc2\xbd", "\xce\x8e", "\xce\x8f",
+	"\xce\x90", "\xce\x91", "\xce\x92", "\xce\x93",
+	"\xce\x94", "\xce\x95", "\xce\x96", "\xce\x97",
+	"\xce\x98", "\xce\x99", "\xce\x9a", "\xce\x9b",
+	"\xce\x9c", "\xce\x9d", "\xce\x9e", "\xce\x9f",
+	"\xce\xa0", "\xce\xa1", "\xef\xbf\xbd", "\xce\xa3",
+	"\xce\xa4", "\xce\xa5", "\xce\xa6", "\xce\xa7",
+	"\xce\xa8", "\xce\xa9", "\xce\xaa", "\xce\xab",
+	"\xce\xac", "\xce\xad", "\xce\xae", "\xce\xaf",
+	"\xce\xb0", "\xce\xb1", "\xce\xb2", "\xce\xb3",
+	"\xce\xb4", "\xce\xb5", "\xce\xb6", "\xce\xb7",
+	"\xce\xb8", "\xce\xb9", "\xce\xba", "\xce\xbb",
+	"\xce\xbc", "\xce\xbd", "\xce\xbe", "\xce\xbf",
+	"\xcf\x80", "\xcf\x81", "\xcf\x82", "\xcf\x83",
+	"\xcf\x84", "\xcf\x85", "\xcf\x86", "\xcf\x87",
+	"\xcf\x88", "\xcf\x89", "\xcf\x8a", "\xcf\x8b",
+	"\xcf\x8c", "\xcf\x8d", "\xcf\x8e", "\xef\xbf\xbd"
+};
+
+
+// ISO-8859-9, Turkish
+static const CodePageTable kISO88599 = {
+	"\xc2\x80", "\xc2\x81", "\xc2\x82", "\xc2\x83",
+	"\xc2\x84", "\xc2\x85", "\xc2\x86", "\xc2\x87",
+	"\xc2\x88", "\xc2\x89", "\xc2\x8a", "\xc2\x8b",
+	"\xc2\x8c", "\xc2\x8d", "\xc2\x8e", "\xc2\x8f",
+	"\xc2\x90", "\xc2\x91", "\xc2\x92", "\xc2\x93",
+	"\xc2\x94", "\xc2\x95", "\xc2\x96", "\xc2\x97",
+	"\xc2\x98", "\xc2\x99", "\xc2\x9a", "\xc2\x9b",
+	"\xc2\x9c", "\xc2\x9d", "\xc2\x9e", "\xc2\x9f",
+	"\xc2\xa0", "\xc2\xa1", "\xc2\xa2", "\xc2\xa3",
+	"\xc2\xa4", "\xc2\xa5", "\xc2\xa6", "\xc2\xa7",
+	"\xc2\xa8", "\xc2\xa9", "\xc2\xaa", "\xc2\xab",
+	"\xc2\xac", "\xc2\xad", "\xc2\xae", "\xc2\xaf",
+	"\xc2\xb0", "\xc2\xb1", "\xc2\xb2", "\xc2\xb3",
+	"\xc2\xb4", "\xc2\xb5", "\xc2\xb6", "\xc2\xb7",
+	"\xc2\xb8", "\xc2\xb9", "\xc2\xba", "\xc2\xbb",
+	"\xc2\xbc", "\xc2\xbd", "\xc2\xbe", "\xc2\xbf",
+	"\xc3\x80", "\xc3\x81", "\xc3\x82", "\xc3\x83",
+	"\xc3\x84", "\xc3\x85", "\xc3\x86", "\xc3\x87",
+	"\xc3\x88", "\xc3\x89", "\xc3\x8a", "\xc3\x8b",
+	"\xc3\x8c", "\xc3\x8d", "\xc3\x8e", "\xc3\x8f",
+	"\xc4\x9e", "\xc3\x91", "\xc3\x92", "\xc3\x93",
+	"\xc3\x94", "\xc3\x95", "\xc3\x96", "\xc3\x97",
+	"\xc3\x98", "\xc3\x99", "\xc3\x9a", "\xc3\x9b",
+	"\xc3\x9c", "\xc4\xb0", "\xc5\x9e", "\xc3\x9f",
+	"\xc3\xa0", "\xc3\xa1", "\xc3\xa2", "\xc3\xa3",
+	"\xc3\xa4", "\xc3\xa5", "\xc3\xa6", "\xc3\xa7",
+	"\xc3\xa8", "\xc3\xa9", "\xc3\xaa", "\xc3\xab",
+	"\xc3\xac", "\xc3\xad", "\xc3\xae", "\xc3\xaf",
+	"\xc4\x9f", "\xc3\xb1", "\xc3\xb2", "\xc3\xb3",
+	"\xc3\xb4", "\xc3\xb5", "\xc3\xb6", "\xc3\xb7",
+	"\xc3\xb8", "\xc3\xb9", "\xc3\xba", "\xc3\xbb",
+	"\xc3\xbc", "\xc4\xb1", "\xc5\x9f", "\xc3\xbf"
+};
+
+
+// ISO-8859-10, Nordic
+static const CodePageTable kISO885910 = {
+	"\xc2\x80", "\xc2\x81", "\xc2\x82", "\xc2\x83",
+	"\xc2\x84", "\xc2\x85", "\xc2\x86", "\xc2\x87",
+	"\xc2\x88", "\xc2\x89", "\xc2\x8a", "\xc2\x8b",
+	"\xc2\x8c", "\xc2\x8d", "\xc2\x8e", "\xc2\x8f",
+	"\xc2\x90", "\xc2\x91", "\xc2\x92", "\xc2\x93",
+	"\xc2\x94", "\xc2\x95", "\xc2\x96", "\xc2\x97",
+	"\xc2\x98", "\xc2\x99", "\xc2\x9a", "\xc2\x9b",
+	"\xc2\x9c", "\xc2\x9d", "\xc2\x9e", "\xc2\x9f",
+	"\xc2\xa0", "\xc4\x84", "\xc4\x92", "\xc4\xa2",
+	"\xc4\xaa", "\xc4\xa8", "\xc4\xb6", "\xc2\xa7",
+	"\xc4\xbb", "\xc4\x90", "\xc5\xa0", "\xc5\xa6",
+	"\xc5\xbd", "\xc2\xad", "\xc5\xaa", "\xc5\x8a",
+	"\xc2\xb0", "\xc4\x85", "\xc4\x93", "\xc4\xa3",
+	"\xc4\xab", "\xc4\xa9", "\xc4\xb7", "\xc2\xb7",
+	"\xc4\xbc", "\xc4\x91", "\xc5\xa1", "\xc5\xa7",
+	"\xc5\xbe", "\xe2\x80\x95", "\xc5\xab", "\xc5\x8b",
+	"\xc4\x80", "\xc3\x81", "\xc3\x82", "\xc3\x83",
+	"\xc3\x84", "\xc3\x85", "\xc3\x86", "\xc4\xae",
+	"\xc4\x8c", "\xc3\x89", "\xc4\x98", "\xc3\x8b",
+	"\xc4\x96", "\xc3\x8d", "\xc3\x8e", "\xc3\x8f",
+	"\xc3\x90", "\xc5\x85", "\xc5\x8c", "\xc3\x93",
+	"\xc3\x94", "\xc3\x95", "\xc3\x96", "\xc5\xa8",
+	"\xc3\x98", "\xc5\xb2", "\xc3\x9a", "\xc3\x9b",
+	"\xc3\x9c", "\xc3\x9d", "\xc3\x9e", "\xc3\x9f",
+	"\xc4\x81", "\xc3\xa1", "\xc3\xa2", "\xc3\xa3",
+	"\xc3\xa4", "\xc3\xa5", "\xc3\xa6", "\xc4\xaf",
+	"\xc4\x8d", "\xc3\xa9", "\xc4\x99", "\xc3\xab",
+	"\xc4\x97", "\xc3\xad", "\xc3\xae", "\xc3\xaf",
+	"\xc3\xb0", "\xc5\x86", "\xc5\x8d", "\xc3\xb3",
+	"\xc3\xb4", "\xc3\xb5", "\xc3\xb6", "\xc5\xa9",
+	"\xc3\xb8", "\xc5\xb3", "\xc3\xba", "\xc3\xbb",
+	"\xc3\xbc", "\xc3\xbd", "\xc3\xbe", "\xc4\xb8"
+};
+
+
+// ISO-8859-13, Baltic
+static const CodePageTable kISO885913 = {
+	"\xc2\x80", "\xc2\x81", "\xc2\x82", "\xc2\x83",
+	"\xc2\x84", "\xc2\x85", "\xc2\x86", "\xc2\x87",
+	"\xc2\x88", "\xc2\x89", "\xc2\x8a", "\xc2\x8b",
+	"\xc2\x8c", "\xc2\x8d", "\xc2\x8e", "\xc2\x8f",
+	"\xc2\x90", "\xc2\x91", "\xc2\x92", "\xc2\x93",
+	"\xc2\x94", "\xc2\x95", "\xc2\x96", "\xc2\x97",
+	"\xc2\x98", "\xc2\x99", "\xc2\x9a", "\xc2\x9b",
+	"\xc2\x9c", "\xc2\x9d", "\xc2\x9e", "\xc2\x9f",
+	"\xc2\xa0", "\xe2\x80\x9d", "\xc2\xa2", "\xc2\xa3",
+	"\xc2\xa4", "\xe2\x80\x9e", "\xc2\xa6", "\xc2\xa7",
+	"\xc3\x98", "\xc2\xa9", "\xc5\x96", "\xc2\xab",
+	"\xc2\xac", "\xc2\xad", "\xc2\xae", "\xc3\x86",
+	"\xc2\xb0", "\xc2\xb1", "\xc2\xb2", "\xc2\xb3",
+	"\xe2\x80\x9c", "\xc2\xb5", "\xc2\xb6", "\xc2\xb7",
+	"\xc3\xb8", "\xc2\xb9", "\xc5\x97", "\xc2\xbb",
+	"\xc2\xbc", "\xc2\xbd", "\xc2\xbe", "\xc3\xa6",
+	"\xc4\x84", "\xc4\xae", "\xc4\x80", "\xc4\x86",
+	"\xc3\x84", "\xc3\x85", "\xc4\x98", "\xc4\x92",
+	"\xc4\x8c", "\xc3\x89", "\xc5\xb9", "\xc4\x96",
+	"\xc4\xa2", "\xc4\xb6", "\xc4\xaa", "\xc4\xbb",
+	"\xc5\xa0", "\xc5\x83", "\xc5\x85", "\xc3\x93",
+	"\xc5\x8c", "\xc3\x95", "\xc3\x96", "\xc3\x97",
+	"\xc5\xb2", "\xc5\x81", "\xc5\x9a", "\xc5\xaa",
+	"\xc3\x9c", "\xc5\xbb", "\xc5\xbd", "\xc3\x9f",
+	"\xc4\x85", "\xc4\xaf", "\xc4\x81", "\xc4\x87",
+	"\xc3\xa4", "\xc3\xa5", "\xc4\x99", "\xc4\x93",
+	"\xc4\x8d", "\xc3\xa9", "\xc5\xba", "\xc4\x97",
+	"\xc4\xa3", "\xc4\xb7", "\xc4\xab", "\xc4\xbc",
+	"\xc5\xa1", "\xc5\x84", "\xc5\x86", "\xc3\xb3",
+	"\xc5\x8d", "\xc3\xb5", "\xc3\xb6", "\xc3\xb7",
+	"\xc5\xb3", "\xc5\x82", "\xc5\x9b", "\xc5\xab",
+	"\xc3\xbc", "\xc5\xbc", "\xc5\xbe", "\xe2\x80\x99"
+};
+
+
+// ISO-8859-14, Celtic
+static const CodePageTable kISO885914 = {
+	"\xc2\x80", "\xc2\x81", "\xc2\x82", "\xc2\x83",
+	"\xc2\x84", "\xc2\x85", "\xc2\x86", "\xc2\x87",
+	"\xc2\x88", "\xc2\x89", "\xc2\x8a", "\xc2\x8b",
+	"\xc2\x8c", "\xc2\x8d", "\xc2\x8e", "\xc2\x8f",
+	"\xc2\x90", "\xc2\x91", "\xc2\x92", "\xc2\x93",
+	"\xc2\x94", "\xc2\x95", "\xc2\x96", "\xc2\x97",
+	"\xc2\x98", "\xc2\x99", "\xc2\x9a", "\xc2\x9b",
+	"\xc2\x9c", "\xc2\x9d", "\xc2\x9e", "\xc2\x9f",
+	"\xc2\xa0", "\xe1\xb8\x82", "\xe1\xb8\x83", "\xc2\xa3",
+	"\xc4\x8a", "\xc4\x8b", "\xe1\xb8\x8a", "\xc2\xa7",
+	"\xe1\xba\x80", "\xc2\xa9", "\xe1\xba\x82", "\xe1\xb8\x8b",
+	"\xe1\xbb\xb2", "\xc2\xad", "\xc2\xae", "\xc5\xb8",
+	"\xe1\xb8\x9e", "\xe1\xb8\x9f", "\xc4\xa0", "\xc4\xa1",
+	"\xe1\xb9\x80", "\xe1\xb9\x81", "\xc2\xb6", "\xe1\xb9\x96",
+	"\xe1\xba\x81", "\xe1\xb9\x97", "\xe1\xba\x83", "\xe1\xb9\xa0",
+	"\xe1\xbb\xb3", "\xe1\xba\x84", "\xe1\xba\x85", "\xe1\xb9\xa1",
+	"\xc3\x80", "\xc3\x81", "\xc3\x82", "\xc3\x83",
+	"\xc3\x84", "\xc3\x85", "\xc3\x86", "\xc3\x87",
+	"\xc3\x88", "\xc3\x89", "\xc3\x8a", "\xc3\x8b",
+	"\xc3\x8c", "\xc3\x8d", "\xc3\x8e", "\xc3\x8f",
+	"\xc5\xb4", "\xc3\x91", "\xc3\x92", "\xc3\x93",
+	"\xc3\x94", "\xc3\x95", "\xc3\x96", "\xe1\xb9\xaa",
+	"\xc3\x98", "\xc3\x99", "\xc3\x9a", "\xc3\x9b",
+	"\xc3\x9c", "\xc3\x9d", "\xc5\xb6", "\xc3\x9f",
+	"\xc3\xa0", "\xc3\xa1", "\xc3\xa2", "\xc3\xa3",
+	"\xc3\xa4", "\xc3\xa5", "\xc3\xa6", "\xc3\xa7",
+	"\xc3\xa8", "\xc3\xa9", "\xc3\xaa", "\xc3\xab",
+	"\xc3\xac", "\xc3\xad", "\xc3\xae", "\xc3\xaf",
+	"\xc5\xb5", "\xc3\xb1", "\xc3\xb2", "\xc3\xb3",
+	"\xc3\xb4", "\xc3\xb5", "\xc3\xb6", "\xe1\xb9\xab",
+	"\xc3\xb8", "\xc3\xb9", "\xc3\xba", "\xc3\xbb",
+	"\xc3\xbc", "\xc3\xbd", "\xc5\xb7", "\xc3\xbf"
+};
+
+
+// ISO-8859-15, Western European with euro
+static const CodePageTable kISO885915 = {
+	"\xc2\x80", "\xc2\x81", "\xc2\x82", "\xc2\x83",
+	"\xc2\x84", "\xc2\x85", "\xc2\x86", "\xc2\x87",
+	"\xc2\x88", "\xc2\x89", "\xc2\x8a", "\xc2\x8b",
+	"\xc2\x8c", "\xc2\x8d", "\xc2\x8e", "\xc2\x8f",
+	"\xc2\x90", "\xc2\x91", "\xc2\x92", "\xc2\x93",
+	"\xc2\x94", "\xc2\x95", "\xc2\x96", "\xc2\x97",
+	"\xc2\x98", "\xc2\x99", "\xc2\x9a", "\xc2\x9b",
+	"\xc2\x9c", "\xc2\x9d", "\xc2\x9e", "\xc2\x9f",
+	"\xc2\xa0", "\xc2\xa1", "\xc2\xa2", "\xc2\xa3",
+	"\xe2\x82\xac", "\xc2\xa5", "\xc5\xa0", "\xc2\xa7",
+	"\xc5\xa1", "\xc2\xa9", "\xc2\xaa", "\xc2\xab",
+	"\xc2\xac", "\xc2\xad", "\xc2\xae", "\xc2\xaf",
+	"\xc2\xb0", "\xc2\xb1", "\xc2\xb2", "\xc2\xb3",
+	"\xc5\xbd", "\xc2\xb5", "\xc2\xb6", "\xc2\xb7",
+	"\xc5\xbe", "\xc2\xb9", "\xc2\xba", "\xc2\xbb",
+	"\xc5\x92", "\xc5\x93", "\xc5\xb8", "\xc2\xbf",
+	"\xc3\x80", "\xc3\x81", "\xc3\x82", "\xc3\x83",
+	"\xc3\x84", "\xc3\x85", "\xc3\x86", "\xc3\x87",
+	"\xc3\x88", "\xc3\x89", "\xc3\x8a", "\xc3\x8b",
+	"\xc3\x8c", "\xc3\x8d", "\xc3\x8e", "\xc3\x8f",
+	"\xc3\x90", "\xc3\x91", "\xc3\x92", "\xc3\x93",
+	"\xc3\x94", "\xc3\x95", "\xc3\x96", "\xc3\x97",
+	"\xc3\x98", "\xc3\x99", "\xc3\x9a", "\xc3\x9b",
+	"\xc3\x9c", "\xc3\x9d", "\xc3\x9e", "\xc3\x9f",
+	"\xc3\xa0", "\xc3\xa1", "\xc3\xa2", "\xc3\xa3",
+	"\xc3\xa4", "\xc3\xa5", "\xc3\xa6", "\xc3\xa7",
+	"\xc3\xa8", "\xc3\xa9", "\xc3\xaa", "\xc3\xab",
+	"\xc3\xac", "\xc3\xad", "\xc3\xae", "\xc3\xaf",
+	"\xc3\xb0", "\xc3\xb1", "\xc3\xb2", "\xc3\xb3",
+	"\xc3\xb4", "\xc3\xb5", "\xc3\xb6", "\xc3\xb7",
+	"\xc3\xb8", "\xc3\xb9", "\xc3\xba", "\xc3\xbb",
+	"\xc3\xbc", "\xc3\xbd", "\xc3\xbe", "\xc3\xbf"
+};
+
+
+// ISO-8859-16, South-Eastern European
+static const CodePageTable kISO885916 = {
+	"\xc2\x80", "\xc2\x81", "\xc2\x82", "\xc2\x83",
+	"\xc2\x84", "\xc2\x85", "\xc2\x86", "\xc2\x87",
+	"\xc2\x88", "\xc2\x89", "\xc2\x8a", "\xc2\x8b",
+	"\xc2\x8c", "\xc2\x8d", "\xc2\x8e", "\xc2\x8f",
+	"\xc2\x90", "\xc2\x91", "\xc2\x92", "\xc2\x93",
+	"\xc2\x94", "\xc2\x95", "\xc2\x96", "\xc2\x97",
+	"\xc2\x98", "\xc2\x99", "\xc2\x9a", "\xc2\x9b",
+	"\xc2\x9c", "\xc2\x9d", "\xc2\x9e", "\xc2\x9f",
+	"\xc2\xa0", "\xc4\x84", "\xc4\x85", "\xc5\x81",
+	"\xe2\x82\xac", "\xe2\x80\x9e", "\xc5\xa0", "\xc2\xa7",
+	"\xc5\xa1", "\xc2\xa9", "\xc8\x98", "\xc2\xab",
+	"\xc5\xb9", "\xc2\xad", "\xc5\xba", "\xc5\xbb",
+	"\xc2\xb0", "\xc2\xb1", "\xc4\x8c", "\xc5\x82",
+	"\xc5\xbd", "\xe2\x80\x9d", "\xc2\xb6", "\xc2\xb7",
+	"\xc5\xbe", "\xc4\x8d", "\xc8\x99", "\xc2\xbb",
+	"\xc5\x92", "\xc5\x93", "\xc5\xb8", "\xc5\xbc",
+	"\xc3\x80", "\xc3\x81", "\xc3\x82", "\xc4\x82",
+	"\xc3\x84", "\xc4\x86", "\xc3\x86", "\xc3\x87",
+	"\xc3\x88", "\xc3\x89", "\xc3\x8a", "\xc3\x8b",
+	"\xc3\x8c", "\xc3\x8d", "\xc3\x8e", "\xc3\x8f",
+	"\xc4\x90", "\xc5\x83", "\xc3\x92", "\xc3\x93",
+	"\xc3\x94", "\xc5\x90", "\xc3\x96", "\xc5\x9a",
+	"\xc5\xb0", "\xc3\x99", "\xc3\x9a", "\xc3\x9b",
+	"\xc3\x9c", "\xc4\x98", "\xc8\x9a", "\xc3\x9f",
+	"\xc3\xa0", "\xc3\xa1", "\xc3\xa2", "\xc4\x83",
+	"\xc3\xa4", "\xc4\x87", "\xc3\xa6", "\xc3\xa7",
+	"\xc3\xa8", "\xc3\xa9", "\xc3\xaa", "\xc3\xab",
+	"\xc3\xac", "\xc3\xad", "\xc3\xae", "\xc3\xaf",
+	"\xc4\x91", "\xc5\x84", "\xc3\xb2", "\xc3\xb3",
+	"\xc3\xb4", "\xc5\x91", "\xc3\xb6", "\xc5\x9b",
+	"\xc5\xb1", "\xc3\xb9", "\xc3\xba", "\xc3\xbb",
+	"\xc3\xbc", "\xc4\x99", "\xc8\x9b", "\xc3\xbf"
+};
+
+
+// KOI8-R, Russian
+static const CodePageTable kKOI8R = {
+	"\xe2\x94\x80", "\xe2\x94\x82", "\xe2\x94\x8c", "\xe2\x94\x90",
+	"\xe2\x94\x94", "\xe2\x94\x98", "\xe2\x94\x9c", "\xe2\x94\xa4",
+	"\xe2\x94\xac", "\xe2\x94\xb4", "\xe2\x94\xbc", "\xe2\x96\x80",
+	"\xe2\x96\x84", "\xe2\x96\x88", "\xe2\x96\x8c", "\xe2\x96\x90",
+	"\xe2\x96\x91", "\xe2\x96\x92", "\xe2\x96\x93", "\xe2\x8c\xa0",
+	"\xe2\x96\xa0", "\xe2\x88\x99", "\xe2\x88\x9a", "\xe2\x89\x88",
+	"\xe2\x89\xa4", "\xe2\x89\xa5", "\xc2\xa0", "\xe2\x8c\xa1",
+	"\xc2\xb0", "\xc2\xb2", "\xc2\xb7", "\xc3\xb7",
+	"\xe2\x95\x90", "\xe2\x95\x91", "\xe2\x95\x92", "\xd1\x91",
+	"\xe2\x95\x93", "\xe2\x95\x94", "\xe2\x95\x95", "\xe2\x95\x96",
+	"\xe2\x95\x97", "\xe2\x95\x98", "\xe2\x95\x99", "\xe2\x95\x9a",
+	"\xe2\x95\x9b", "\xe2\x95\x9c", "\xe2\x95\x9d", "\xe2\x95\x9e",
+	"\xe2\x95\x9f", "\xe2\x95\xa0", "\xe2\x95\xa1", "\xd0\x81",
+	"\xe2\x95\xa2", "\xe2\x95\xa3", "\xe2\x95\xa4", "\xe2\x95\xa5",
+	"\xe2\x95\xa6", "\xe2\x95\xa7", "\xe2\x95\xa8", "\xe2\x95\xa9",
+	"\xe2\x95\xaa", "\xe2\x95\xab", "\xe2\x95\xac", "\xc2\xa9",
+	"\xd1\x8e", "\xd0\xb0", "\xd0\xb1", "\xd1\x86",
+	"\xd0\xb4", "\xd0\xb5", "\xd1\x84", "\xd0\xb3",
+	"\xd1\x85", "\xd0\xb8", "\xd0\xb9", "\xd0\xba",
+	"\xd0\xbb", "\xd0\xbc", "\xd0\xbd", "\xd0\xbe",
+	"\xd0\xbf", "\xd1\x8f", "\xd1\x80", "\xd1\x81",
+	"\xd1\x82", "\xd1\x83", "\xd0\xb6", "\xd0\xb2",
+	"\xd1\x8c", "\xd1\x8b", "\xd0\xb7", "\xd1\x88",
+	"\xd1\x8d", "\xd1\x89", "\xd1\x87", "\xd1\x8a",
+	"\xd0\xae", "\xd0\x90", "\xd0\x91", "\xd0\xa6",
+	"\xd0\x94", "\xd0\x95", "\xd0\xa4", "\xd0\x93",
+	"\xd0\xa5", "\xd0\x98", "\xd0\x99", "\xd0\x9a",
+	"\xd0\x9b", "\xd0\x9c", "\xd0\x9d", "\xd0\x9e",
+	"\xd0\x9f", "\xd0\xaf", "\xd0\xa0", "\xd0\xa1",
+	"\xd0\xa2", "\xd0\xa3", "\xd0\x96", "\xd0\x92",
+	"\xd0\xac", "\xd0\xab", "\xd0\x97", "\xd0\xa8",
+	"\xd0\xad", "\xd0\xa9", "\xd0\xa7", "\xd0\xaa"
+};
+
+
+// windows-1250, Central European
+static const CodePageTable kWindows1250 = {
+	"\xe2\x82\xac", "\xef\xbf\xbd", "\xe2\x80\x9a", "\xef\xbf\xbd",
+	"\xe2\x80\x9e", "\xe2\x80\xa6", "\xe2\x80\xa0", "\xe2\x80\xa1",
+	"\xef\xbf\xbd", "\xe2\x80\xb0", "\xc5\xa0", "\xe2\x80\xb9",
+	"\xc5\x9a", "\xc5\xa4", "\xc5\xbd", "\xc5\xb9",
+	"\xef\xbf\xbd", "\xe2\x80\x98", "\xe2\x80\x99", "\xe2\x80\x9c",
+	"\xe2\x80\x9d", "\xe2\x80\xa2", "\xe2\x80\x93", "\xe2\x80\x94",
+	"\xef\xbf\xbd", "\xe2\x84\xa2", "\xc5\xa1", "\xe2\x80\xba",
+	"\xc5\x9b", "\xc5\xa5", "\xc5\xbe", "\xc5\xba",
+	"\xc2\xa0", "\xcb\x87", "\xcb\x98", "\xc5\x81",
+	"\xc2\xa4", "\xc4\x84", "\xc2\xa6", "\xc2\xa7",
+	"\xc2\xa8", "\xc2\xa9", "\xc5\x9e", "\xc2\xab",
+	"\xc2\xac", "\xc2\xad", "\xc2\xae", "\xc5\xbb",
+	"\xc2\xb0", "\xc2\xb1", "\xcb\x9b", "\xc5\x82",
+	"\xc2\xb4", "\xc2\xb5", "\xc2\xb6", "\xc2\xb7",
+	"\xc2\xb8", "\xc4\x85", "\xc5\x9f", "\xc2\xbb",
+	"\xc4\xbd", "\xcb\x9d", "\xc4\xbe", "\xc5\xbc",
+	"\xc5\x94", "\xc3\x81", "\xc3\x82", "\xc4\x82",
+	"\xc3\x84", "\xc4\xb9", "\xc4\x86", "\xc3\x87",
+	"\xc4\x8c", "\xc3\x89", "\xc4\x98", "\xc3\x8b",
+	"\xc4\x9a", "\xc3\x8d", "\xc3\x8e", "\xc4\x8e",
+	"\xc4\x90", "\xc5\x83", "\xc5\x87", "\xc3\x93",
+	"\xc3\x94", "\xc5\x90", "\xc3\x96", "\xc3\x97",
+	"\xc5\x98", "\xc5\xae", "\xc3\x9a", "\xc5\xb0",
+	"\xc3\x9c", "\xc3\x9d", "\xc5\xa2", "\xc3\x9f",
+	"\xc5\x95", "\xc3\xa1", "\xc3\xa2", "\xc4\x83",
+	"\xc3\xa4", "\xc4\xba", "\xc4\x87", "\xc3\xa7",
+	"\xc4\x8d", "\xc3\xa9", "\xc4\x99", "\xc3\xab",
+	"\xc4\x9b", "\xc3\xad", "\xc3\xae", "\xc4\x8f",
+	"\xc4\x91", "\xc5\x84", "\xc5\x88", "\xc3\xb3",
+	"\xc3\xb4", "\xc5\x91", "\xc3\xb6", "\xc3\xb7",
+	"\xc5\x99", "\xc5\xaf", "\xc3\xba", "\xc5\xb1",
+	"\xc3\xbc", "\xc3\xbd", "\xc5\xa3", "\xcb\x99"
+};
+
+
+// windows-1251, Cyrillic
+static const CodePageTable kWindows1251 = {
+	"\xd0\x82", "\xd0\x83", "\xe2\x80\x9a", "\xd1\x93",
+	"\xe2\x80\x9e", "\xe2\x80\xa6", "\xe2\x80\xa0", "\xe2\x80\xa1",
+	"\xe2\x82\xac", "\xe2\x80\xb0", "\xd0\x89", "\xe2\x80\xb9",
+	"\xd0\x8a", "\xd0\x8c", "\xd0\x8b", "\xd0\x8f",
+	"\xd1\x92", "\xe2\x80\x98", "\xe2\x80\x99", "\xe2\x80\x9c",
+	"\xe2\x80\x9d", "\xe2\x80\xa2", "\xe2\x80\x93", "\xe2\x80\x94",
+	"\xef\xbf\xbd", "\xe2\x84\xa2", "\xd1\x99", "\xe2\x80\xba",
+	"\xd1\x9a", "\xd1\x9c", "\xd1\x9b", "\xd1\x9f",
+	"\xc2\xa0", "\xd0\x8e", "\xd1\x9e", "\xd0\x88",
+	"\xc2\xa4", "\xd2\x90", "\xc2\xa6", "\xc2\xa7",
+	"\xd0\x81", "\xc2\xa9", "\xd0\x84", "\xc2\xab",
+	"\xc2\xac", "\xc2\xad", "\xc2\xae", "\xd0\x87",
+	"\xc2\xb0", "\xc2\xb1", "\xd0\x86", "\xd1\x96",
+	"\xd2\x91", "\xc2\xb5", "\xc2\xb6", "\xc2\xb7",
+	"\xd1\x91", "\xe2\x84\x96", "\xd1\x94", "\xc2\xbb",
+	"\xd1\x98", "\xd0\x85", "\xd1\x95", "\xd1\x97",
+	"\xd0\x90", "\xd0\x91", "\xd0\x92", "\xd0\x93",
+	"\xd0\x94", "\xd0\x95", "\xd0\x96", "\xd0\x97",
+	"\xd0\x98", "\xd0\x99", "\xd0\x9a", "\xd0\x9b",
+	"\xd0\x9c", "\xd0\x9d", "\xd0\x9e", "\xd0\x9f",
+	"\xd0\xa0", "\xd0\xa1", "\xd0\xa2", "\xd0\xa3",
+	"\xd0\xa4", "\xd0\xa5", "\xd0\xa6", "\xd0\xa7",
+	"\xd0\xa8", "\xd0\xa9", "\xd0\xaa", "\xd0\xab",
+	"\xd0\xac", "\xd0\xad", "\xd0\xae", "\xd0\xaf",
+	"\xd0\xb0", "\xd0\xb1", "\xd0\xb2", "\xd0\xb3",
+	"\xd0\xb4", "\xd0\xb5", "\xd0\xb6", "\xd0\xb7",
+	"\xd0\xb8", "\xd0\xb9", "\xd0\xba", "\xd0\xbb",
+	"\xd0\xbc", "\xd0\xbd", "\xd0\xbe", "\xd0\xbf",
+	"\xd1\x80", "\xd1\x81", "\xd1\x82", "\xd1\x83",
+	"\xd1\x84", "\xd1\x85", "\xd1\x86", "\xd1\x87",
+	"\xd1\x88", "\xd1\x89", "\xd1\x8a", "\xd1\x8b",
+	"\xd1\x8c", "\xd1\x8d", "\xd1\x8e", "\xd1\x8f"
+};
+
+
+// windows-1252, Western European
+static const CodePageTable kWindows1252 = {
+	"\xe2\x82\xac", "\xef\xbf\xbd", "\xe2\x80\x9a", "\xc6\x92",
+	"\xe2\x80\x9e", "\xe2\x80\xa6", "\xe2\x80\xa0", "\xe2\x80\xa1",
+	"\xcb\x86", "\xe2\x80\xb0", "\xc5\xa0", "\xe2\x80\xb9",
+	"\xc5\x92", "\xef\xbf\xbd", "\xc5\xbd", "\xef\xbf\xbd",
+	"\xef\xbf\xbd", "\xe2\x80\x98", "\xe2\x80\x99", "\xe2\x80\x9c",
+	"\xe2\x80\x9d", "\xe2\x80\xa2", "\xe2\x80\x93", "\xe2\x80\x94",
+	"\xcb\x9c", "\xe2\x84\xa2", "\xc5\xa1", "\xe2\x80\xba",
+	"\xc5\x93", "\xef\xbf\xbd", "\xc5\xbe", "\xc5\xb8",
+	"\xc2\xa0", "\xc2\xa1", "\xc2\xa2", "\xc2\xa3",
+	"\xc2\xa4", "\xc2\xa5", "\xc2\xa6", "\xc2\xa7",
+	"\xc2\xa8", "\xc2\xa9", "\xc2\xaa", "\xc2\xab",
+	"\xc2\xac", "\xc2\xad", "\xc2\xae", "\xc2\xaf",
+	"\xc2\xb0", "\xc2\xb1", "\xc2\xb2", "\xc2\xb3",
+	"\xc2\xb4", "\xc2\xb5", "\xc2\xb6", "\xc2\xb7",
+	"\xc2\xb8", "\xc2\xb9", "\xc2\xba", "\xc2\xbb",
+	"\xc2\xbc", "\xc2\xbd", "\xc2\xbe", "\xc2\xbf",
+	"\xc3\x80", "\xc3\x81", "\xc3\x82", "\xc3\x83",
+	"\xc3\x84", "\xc3\x85", "\xc3\x86", "\xc3\x87",
+	"\xc3\x88", "\xc3\x89", "\xc3\x8a", "\xc3\x8b",
+	"\xc3\x8c", "\xc3\x8d", "\xc3\x8e", "\xc3\x8f",
+	"\xc3\x90", "\xc3\x91", "\xc3\x92", "\xc3\x93",
+	"\xc3\x94", "\xc3\x95", "\xc3\x96", "\xc3\x97",
+	"\xc3\x98", "\xc3\x99", "\xc3\x9a", "\xc3\x9b",
+	"\xc3\x9c", "\xc3\x9d", "\xc3\x9e", "\xc3\x9f",
+	"\xc3\xa0", "\xc3\xa1", "\xc3\xa2", "\xc3\xa3",
+	"\xc3\xa4", "\xc3\xa5", "\xc3\xa6", "\xc3\xa7",
+	"\xc3\xa8", "\xc3\xa9", "\xc3\xaa", "\xc3\xab",
+	"\xc3\xac", "\xc3\xad", "\xc3\xae", "\xc3\xaf",
+	"\xc3\xb0", "\xc3\xb1", "\xc3\xb2", "\xc3\xb3",
+	"\xc3\xb4", "\xc3\xb5", "\xc3\xb6", "\xc3\xb7",
+	"\xc3\xb8", "\xc3\xb9", "\xc3\xba", "\xc3\xbb",
+	"\xc3\xbc", "\xc3\xbd", "\xc3\xbe", "\xc3\xbf"
+};
+
+
+// windows-1253, Greek
+static const CodePageTable kWindows1253 = {
+	"\xe2\x82\xac", "\xef\xbf\xbd", "\xe2\x80\x9a", "\xc6\x92",
+	"\xe2\x80\x9e", "\xe2\x80\xa6", "\xe2\x80\xa0", "\xe2\x80\xa1",
+	"\xef\xbf\xbd", "\xe2\x80\xb0", "\xef\xbf\xbd", "\xe2\x80\xb9",
+	"\xef\xbf\xbd", "\xef\xbf\xbd", "\xef\xbf\xbd", "\xef\xbf\xbd",
+	"\xef\xbf\xbd", "\xe2\x80\x98", "\xe2\x80\x99", "\xe2\x80\x9c",
+	"\xe2\x80\x9d", "\xe2\x80\xa2", "\xe2\x80\x93", "\xe2\x80\x94",
+	"\xef\xbf\xbd", "\xe2\x84\xa2", "\xef\xbf\xbd", "\xe2\x80\xba",
+	"\xef\xbf\xbd", "\xef\xbf\xbd", "\xef\xbf\xbd", "\xef\xbf\xbd",
+	"\xc2\xa0", "\xce\x85", "\xce\x86", "\xc2\xa3",
+	"\xc2\xa4", "\xc2\xa5", "\xc2\xa6", "\xc2\xa7",
+	"\xc2\xa8", "\xc2\xa9", "\xef\xbf\xbd", "\xc2\xab",
+	"\xc2\xac", "\xc2\xad", "\xc2\xae", "\xe2\x80\x95",
+	"\xc2\xb0", "\xc2\xb1", "\xc2\xb2", "\xc2\xb3",
+	"\xce\x84", "\xc2\xb5", "\xc2\xb6", "\xc2\xb7",
+	"\xce\x88", "\xce\x89", "\xce\x8a", "\xc2\xbb",
+	"\xce\x8c", "\xc2\xbd", "\xce\x8e", "\xce\x8f",
+	"\xce\x90", "\xce\x91", "\xce\x92", "\xce\x93",
+	"\xce\x94", "\xce\x95", "\xce\x96", "\xce\x97",
+	"\xce\x98", "\xce\x99", "\xce\x9a", "\xce\x9b",
+	"\xce\x9c", "\xce\x9d", "\xce\x9e", "\xce\x9f",
+	"\xce\xa0", "\xce\xa1", "\xef\xbf\xbd", "\xce\xa3",
+	"\xce\xa4", "\xce\xa5", "\xce\xa6", "\xce\xa7",
+	"\xce\xa8", "\xce\xa9", "\xce\xaa", "\xce\xab",
+	"\xce\xac", "\xce\xad", "\xce\xae", "\xce\xaf",
+	"\xce\xb0", "\xce\xb1", "\xce\xb2", "\xce\xb3",
+	"\xce\xb4", "\xce\xb5", "\xce\xb6", "\xce\xb7",
+	"\xce\xb8", "\xce\xb9", "\xce\xba", "\xce\xbb",
+	"\xce\xbc", "\xce\xbd", "\xce\xbe", "\xce\xbf",
+	"\xcf\x80", "\xcf\x81", "\xcf\x82", "\xcf\x83",
+	"\xcf\x84", "\xcf\x85", "\xcf\x86", "\xcf\x87",
+	"\xcf\x88", "\xcf\x89", "\xcf\x8a", "\xcf\x8b",
+	"\xcf\x8c", "\xcf\x8d", "\xcf\x8e", "\xef\xbf\xbd"
+};
+
+
+// windows-1257, Baltic
+static const CodePageTable kWindows1257 = {
+	"\xe2\x82\xac", "\xef\xbf\xbd", "\xe2\x80\x9a", "\xef\xbf\xbd",
+	"\xe2\x80\x9e", "\xe2\x80\xa6", "\xe2\x80\xa0", "\xe2\x80\xa1",
+	"\xef\xbf\xbd", "\xe2\x80\xb0", "\xef\xbf\xbd", "\xe2\x80\xb9",
+	"\xef\xbf\xbd", "\xc2\xa8", "\xcb\x87", "\xc2\xb8",
+	"\xef\xbf\xbd", "\xe2\x80\x98", "\xe2\x80\x99", "\xe2\x80\x9c",
+	"\xe2\x80\x9d", "\xe2\x80\xa2", "\xe2\x80\x93", "\xe2\x80\x94",
+	"\xef\xbf\xbd", "\xe2\x84\xa2", "\xef\xbf\xbd", "\xe2\x80\xba",
+	"\xef\xbf\xbd", "\xc2\xaf", "\xcb\x9b", "\xef\xbf\xbd",
+	"\xc2\xa0", "\xef\xbf\xbd", "\xc2\xa2", "\xc2\xa3",
+	"\xc2\xa4", "\xef\xbf\xbd", "\xc2\xa6", "\xc2\xa7",
+	"\xc3\x98", "\xc2\xa9", "\xc5\x96", "\xc2\xab",
+	"\xc2\xac", "\xc2\xad", "\xc2\xae", "\xc3\x86",
+	"\xc2\xb0", "\xc2\xb1", "\xc2\xb2", "\xc2\xb3",
+	"\xc2\xb4", "\xc2\xb5", "\xc2\xb6", "\xc2\xb7",
+	"\xc3\xb8", "\xc2\xb9", "\xc5\x97", "\xc2\xbb",
+	"\xc2\xbc", "\xc2\xbd", "\xc2\xbe", "\xc3\xa6",
+	"\xc4\x84", "\xc4\xae", "\xc4\x80", "\xc4\x86",
+	"\xc3\x84", "\xc3\x85", "\xc4\x98", "\xc4\x92",
+	"\xc4\x8c", "\xc3\x89", "\xc5\xb9", "\xc4\x96",
+	"\xc4\xa2", "\xc4\xb6", "\xc4\xaa", "\xc4\xbb",
+	"\xc5\xa0", "\xc5\x83", "\xc5\x85", "\xc3\x93",
+	"\xc5\x8c", "\xc3\x95", "\xc3\x96", "\xc3\x97",
+	"\xc5\xb2", "\xc5\x81", "\xc5\x9a", "\xc5\xaa",
+	"\xc3\x9c", "\xc5\xbb", "\xc5\xbd", "\xc3\x9f",
+	"\xc4\x85", "\xc4\xaf", "\xc4\x81", "\xc4\x87",
+	"\xc3\xa4", "\xc3\xa5", "\xc4\x99", "\xc4\x93",
+	"\xc4\x8d", "\xc3\xa9", "\xc5\xba", "\xc4\x97",
+	"\xc4\xa3", "\xc4\xb7", "\xc4\xab", "\xc4\xbc",
+	"\xc5\xa1", "\xc5\x84", "\xc5\x86", "\xc3\xb3",
+	"\xc5\x8d", "\xc3\xb5", "\xc3\xb6", "\xc3\xb7",
+	"\xc5\xb3", "\xc5\x82", "\xc5\x9b", "\xc5\xab",
+	"\xc3\xbc", "\xc5\xbc", "\xc5\xbe", "\xcb\x99"
+};
+
+
+class CodePageDecoder : public IDStringTable::Decoder {
+	public:
+		CodePageDecoder(uint32_t codeSet, const CodePageTable& table)
+			:
+			fCodeSet(codeSet),
+			fTable(table)
+		{
+		}
+
+		uint32_t CodeSet() const
+		{
+			return fCodeSet;
+		}
+
+		size_t MaxDecodedLength(size_t length) const
+		{
+			// No code page goes beyond the BMP
+			return length * 3;
+		}
+
+		size_t Decode(const char* string, size_t length, char* target) const
+		{
+			char* start = target;
+			for (size_t i = 0; i < length; i++) {
+				uint8_t c = string[i];
+				if (c < 0x80) {
+					*target++ = c;
+					continue;
+				}
+
+				// Always copy 3 bytes, the next character overwrites the
+				// last one of 2 byte sequences.
+				const char* utf8 = fTable[c - 0x80];
+				target[0] = utf8[0];
+				target[1] = utf8[1];
+				target[2] = utf8[2];
+				target += ((uint8_t)utf8[0] & 0xe0) == 0xc0 ? 2 : 3;
+			}
+			return target - start;
+		}
+
+	private:
+		uint32_t				fCodeSet;
+		const CodePageTable&	fTable;
+};
+
+
+// by IANA MIBenum
+static const CodePageDecoder kCodePageDecoders[] = {
+	CodePageDecoder(5, kISO88592),
+	CodePageDecoder(6, kISO88593),
+	CodePageDecoder(7, kISO88594),
+	CodePageDecoder(8, kISO88595),
+	CodePageDecoder(10, kISO88597),
+	CodePageDecoder(12, kISO88599),
+	CodePageDecoder(13, kISO885910),
+	CodePageDecoder(109, kISO885913),
+	CodePageDecoder(110, kISO885914),
+	CodePageDecoder(111, kISO885915),
+	CodePageDecoder(112, kISO885916),
+	CodePageDecoder(2084, kKOI8R),
+	CodePageDecoder(2250, kWindows1250),
+	CodePageDecoder(2251, kWindows1251),
+	CodePageDecoder(2252, kWindows1252),
+	CodePageDecoder(2253, kWindows1253),
+	CodePageDecoder(2257, kWindows1257)
+};
+
+
+const IDStringTable::Decoder*
+BPrivate::code_page_decoder(uint32_t codeSet)
+{
+	for (size_t i = 0; i < sizeof(kCodePageDecoders)
+			/ sizeof(kCodePageDecoders[0]); i++) {
+		if (kCodePageDecoders[i].CodeSet() == codeSet)
+			return &kCodePageDecoders[i];
+	}
+	return NULL;
+}
@@ -0,0 +1,27 @@
+/*
+ * Copyright 2026, Adrien Destugues, pulkomandy@pulkomandy.tk.
+ * Distributed under the terms of the MIT License.
+ */
+#ifndef _CODE_PAGES_H_
+#define _CODE_PAGES_H_
+
+
+#include <stdint.h>
+
+#include "StringTable.h"
+
+
+namespace BPrivate {
+
+
+const IDStringTable::Decoder* code_page_decoder(uint32_t codeSet);
+	// Returns a decoder converting strings in the 8-bit code page with the
+	// given IANA MIBenum (the value of the CSET chunk) to UTF-8, or NULL if
+	// the code page isn't known. ISO-8859-1 and UTF-8 are left to the
+	// catalog, which has faster decoders for them.
+
+
+} // namespace BPrivate
+
+
+#endif /* _CODE_PAGES_H_ */
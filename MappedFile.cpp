@@ -0,0 +1,99 @@
+/*
+ * Copyright 2026, Adrien Destugues, pulkomandy@pulkomandy.tk.
+ * Distributed under the terms of the MIT License.
+ */
+
+#include "MappedFile.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include <sys/mman.h>
+
+
+using BPrivate::MappedFile;
+
+
+MappedFile::MappedFile(const char* path, Mode mode)
+	:
+	fData(NULL),
+	fSize(0),
+	fMapped(false),
+	fInitStatus(0)
+{
+	memset(&fStat, 0, sizeof(fStat));
+
+	int fd = open(path, O_RDONLY);
+	if (fd < 0) {
+		fInitStatus = errno;
+		return;
+	}
+
+	if (fstat(fd, &fStat) != 0) {
+		fInitStatus = errno;
+		close(fd);
+		return;
+	}
+
+	fSize = fStat.st_size;
+	if (fSize == 0) {
+		close(fd);
+		return;
+	}
+
+	if (mode != kRead) {
+		void* data = mmap(NULL, fSize, PROT_READ, MAP_PRIVATE, fd, 0);
+		if (data != MAP_FAILED) {
+			fData = (const uint8_t*)data;
+			fMapped = true;
+			close(fd);
+			return;
+		}
+
+		if (mode == kMapOnly) {
+			fInitStatus = errno;
+			fSize = 0;
+			close(fd);
+			return;
+		}
+	}
+
+	// Read the whole file at once, when it must not be mapped or its volume
+	// can't be. If it gets shorter meanwhile, reading fails rather than
+	// returning part of it.
+	uint8_t* buffer = (uint8_t*)malloc(fSize);
+	if (buffer == NULL) {
+		fInitStatus = ENOMEM;
+		close(fd);
+		return;
+	}
+
+	size_t done = 0;
+	while (done < fSize) {
+		ssize_t bytesRead = read(fd, buffer + done, fSize - done);
+		if (bytesRead < 0 && errno == EINTR)
+			continue;
+		if (bytesRead <= 0) {
+			fInitStatus = bytesRead < 0 ? errno : EIO;
+			free(buffer);
+			close(fd);
+			return;
+		}
+		done += bytesRead;
+	}
+
+	close(fd);
+	fData = buffer;
+}
+
+
+MappedFile::~MappedFile()
+{
+	if (fMapped)
+		munmap((void*)fData, fSize);
+	else
+		free((void*)fData);
+}
@@ -0,0 +1,64 @@
+/*
+ * Copyright 2026, Adrien Destugues, pulkomandy@pulkomandy.tk.
+ * Distributed under the terms of the MIT License.
+ */
+#ifndef _MAPPED_FILE_H_
+#define _MAPPED_FILE_H_
+
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <sys/stat.h>
+
+
+namespace BPrivate {
+
+
+/*	Read-only view of a whole file. The file is mapped in memory when
+ *	possible, so the catalog parser can walk it in place without any further
+ *	read syscalls. If the file can't be mapped, it is read with a single read
+ *	into a heap buffer instead, unless the mode is kMapOnly.
+ *
+ *	A mapping follows the file: truncating it makes accessing the missing
+ *	pages fault with SIGBUS, and writing to it may change what is seen. Only
+ *	files that are replaced by renaming another one over them should be
+ *	mapped for longer than it takes to parse them, or while they may still
+ *	be written. Others are read with kRead, into memory of their own.
+ */
+class MappedFile {
+	public:
+		enum Mode {
+			kMapOrRead,
+			kMapOnly,
+			kRead
+		};
+
+		MappedFile(const char* path, Mode mode = kMapOrRead);
+		~MappedFile();
+
+		int InitCheck() const { return fInitStatus; }
+			// 0 on success, an errno value otherwise
+
+		const uint8_t* Data() const { return fData; }
+		size_t Size() const { return fSize; }
+		const struct stat& Stat() const { return fStat; }
+			// of the file that was opened, even if the path now points to
+			// another one
+
+	private:
+		MappedFile(const MappedFile&);
+		MappedFile& operator=(const MappedFile&);
+
+		const uint8_t*	fData;
+		size_t			fSize;
+		struct stat		fStat;
+		bool			fMapped;
+		int				fInitStatus;
+};
+
+
+} // namespace BPrivate
+
+
+#endif /* _MAPPED_FILE_H_ */
@@ -0,0 +1,151 @@
+/*
+ * Copyright 2026, Adrien Destugues, pulkomandy@pulkomandy.tk.
+ * Distributed under the terms of the MIT License.
+ */
+
+#include "RandomCatalog.h"
+
+#include <errno.h>
+
+#include <new>
+#include <random>
+
+#include "CTLGReader.h"
+#include "CTLGWriter.h"
+
+
+using BPrivate::kCTLGCodeSetUTF8;
+
+
+static const char kASCIICharacters[]
+	= "abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789    .,";
+
+// Non-ASCII characters of UTF-8 catalogs, from 2 to 4 bytes long
+static const struct { uint32_t first; uint32_t last; } kUnicodeRanges[] = {
+	{ 0x00c0, 0x00ff },		// Latin-1
+	{ 0x0410, 0x044f },		// Cyrillic
+	{ 0x4e00, 0x9fff },		// CJK
+	{ 0x1f600, 0x1f64f }	// Emoji
+};
+
+
+static void
+append_utf8(std::string& string, uint32_t c)
+{
+	if (c < 0x800) {
+		string += (char)(0xc0 | (c >> 6));
+	} else if (c < 0x10000) {
+		string += (char)(0xe0 | (c >> 12));
+		string += (char)(0x80 | ((c >> 6) & 0x3f));
+	} else {
+		string += (char)(0xf0 | (c >> 18));
+		string += (char)(0x80 | ((c >> 12) & 0x3f));
+		string += (char)(0x80 | ((c >> 6) & 0x3f));
+	}
+	string += (char)(0x80 | (c & 0x3f));
+}
+
+
+/*!	Makes a string of \a length characters. In 8-bit code sets, the non-ASCII
+	ones are taken from the upper half of the code page, which most code
+	pages fill with printable characters.
+*/
+static void
+generate_string(std::mt19937& random, size_t length, uint32_t codeSet,
+	unsigned nonASCIIPercent, std::string& string)
+{
+	std::uniform_int_distribution<unsigned> percent(0, 99);
+	std::uniform_int_distribution<size_t> ascii(0,
+		sizeof(kASCIICharacters) - 2);
+	std::uniform_int_distribution<size_t> range(0,
+		sizeof(kUnicodeRanges) / sizeof(kUnicodeRanges[0]) - 1);
+	std::uniform_int_distribution<unsigned> upperHalf(0xa0, 0xff);
+
+	string.clear();
+	for (size_t i = 0; i < length; i++) {
+		if (percent(random) >= nonASCIIPercent)
+			string += kASCIICharacters[ascii(random)];
+		else if (codeSet == kCTLGCodeSetUTF8) {
+			size_t index = range(random);
+			std::uniform_int_distribution<uint32_t> character(
+				kUnicodeRanges[index].first, kUnicodeRanges[index].last);
+			append_utf8(string, character(random));
+		} else
+			string += (char)upperHalf(random);
+	}
+}
+
+
+BPrivate::RandomCatalogShape::RandomCatalogShape()
+	:
+	count(1000),
+	density(1.0),
+	minLength(5),
+	maxLength(80),
+	codeSet(kCTLGCodeSetUTF8),
+	nonASCIIPercent(10),
+	seed(1)
+{
+}
+
+
+int
+BPrivate::generate_random_strings(const RandomCatalogShape& shape,
+	std::vector<RandomString>& strings)
+{
+	// The IDs are spread over a range count / density wide
+	double idRange = shape.count / shape.density;
+	if (shape.density <= 0 || idRange > (double)UINT32_MAX + 1)
+		return EINVAL;
+
+	std::mt19937 random(shape.seed);
+	std::uniform_int_distribution<size_t> length(shape.minLength,
+		shape.maxLength);
+	std::uniform_real_distribution<double> draw(0, 1);
+
+	try {
+		strings.resize(shape.count);
+
+		// Picks each ID with the probability of still needing one, which
+		// gives exactly count distinct IDs in increasing order.
+		uint64_t remainingIDs = (uint64_t)idRange;
+		uint32_t id = 0;
+		for (size_t i = 0; i < shape.count; id++, remainingIDs--) {
+			if (draw(random) * remainingIDs >= shape.count - i)
+				continue;
+
+			strings[i].id = id;
+			generate_string(random, length(random), shape.codeSet,
+				shape.nonASCIIPercent, strings[i].string);
+			i++;
+		}
+	} catch (const std::bad_alloc&) {
+		return ENOMEM;
+	}
+	return 0;
+}
+
+
+int
+BPrivate::generate_random_catalog(const RandomCatalogShape& shape,
+	const char* version, const char* language, std::vector<uint8_t>& buffer,
+	uint32_t& fingerprint)
+{
+	std::vector<RandomString> strings;
+	int error = generate_random_strings(shape, strings);
+	if (error != 0)
+		return error;
+
+	CTLGWriter writer(version, language);
+	writer.SetCodeSet(shape.codeSet);
+	for (size_t i = 0; i < strings.size(); i++) {
+		if (!writer.AddString(strings[i].id, strings[i].string.c_str(),
+				strings[i].string.size()))
+			return ENOMEM;
+	}
+
+	if (!writer.Flatten(buffer))
+		return E2BIG;
+	fingerprint = writer.Fingerprint();
+	return 0;
+}
@@ -0,0 +1,68 @@
+/*
+ * Copyright 2026, Adrien Destugues, pulkomandy@pulkomandy.tk.
+ * Distributed under the terms of the MIT License.
+ */
+#ifndef _RANDOM_CATALOG_H_
+#define _RANDOM_CATALOG_H_
+
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <string>
+#include <vector>
+
+
+/*	Catalogs with random strings, to measure how the add-on behaves with
+ *	catalogs of various shapes without needing real translations of that
+ *	size. The number of strings, the share of the ID range they use, the
+ *	range of their lengths, the code set and how many of their characters
+ *	are not ASCII can be chosen. The same seed always gives the same
+ *	strings, so measurements made before and after a change use the same
+ *	data.
+ */
+
+
+namespace BPrivate {
+
+
+struct RandomCatalogShape {
+	size_t		count;
+	double		density;
+		// share of the ID range starting at 0 that is used, up to 1
+	size_t		minLength;
+	size_t		maxLength;
+		// in characters, which take several bytes in UTF-8
+	uint32_t	codeSet;
+		// as in CSET chunks, 8-bit code sets get characters from the upper
+		// half of the code page
+	unsigned	nonASCIIPercent;
+	uint32_t	seed;
+
+	RandomCatalogShape();
+		// 1000 dense UTF-8 strings of 5 to 80 characters, 10% non-ASCII
+};
+
+
+struct RandomString {
+	uint32_t	id;
+	std::string	string;
+};
+
+
+int generate_random_strings(const RandomCatalogShape& shape,
+	std::vector<RandomString>& strings);
+	// Sets strings to the strings of the catalog, in ascending ID order.
+	// Returns 0 on success, EINVAL if the IDs don't fit in 32 bits, or
+	// ENOMEM.
+int generate_random_catalog(const RandomCatalogShape& shape,
+	const char* version, const char* language, std::vector<uint8_t>& buffer,
+	uint32_t& fingerprint);
+	// Same as above, flattened into a CTLG file, or E2BIG if it is too
+	// large for one.
+
+
+} // namespace BPrivate
+
+
+#endif /* _RANDOM_CATALOG_H_ */
@@ -0,0 +1,221 @@
+/*
+ * Copyright 2026, Adrien Destugues, pulkomandy@pulkomandy.tk.
+ * Distributed under the terms of the MIT License.
+ */
+
+#include "SharedImage.h"
+
+#include <errno.h>
+#include <string.h>
+
+#ifndef __HAIKU__
+#	include <fcntl.h>
+#	include <limits.h>
+#	include <stdio.h>
+#	include <unistd.h>
+#	include <sys/mman.h>
+#	include <sys/stat.h>
+#endif
+
+
+using BPrivate::SharedImage;
+
+
+/*!	Other processes may find the image as soon as it is created, so the
+	first word is written last: readers check it before using the rest.
+*/
+static void
+copy_image(void* target, const void* data, size_t size)
+{
+	uint32_t first;
+	memcpy(&first, data, sizeof(first));
+	memcpy((uint8_t*)target + sizeof(first),
+		(const uint8_t*)data + sizeof(first), size - sizeof(first));
+	__atomic_store_n((uint32_t*)target, first, __ATOMIC_RELEASE);
+}
+
+
+#ifdef __HAIKU__
+
+
+SharedImage::SharedImage(const char* name)
+	:
+	fData(NULL),
+	fSize(0),
+	fInitStatus(B_OK),
+	fArea(-1)
+{
+	area_id source = find_area(name);
+	if (source < 0) {
+		fInitStatus = source;
+		return;
+	}
+
+	// Clones can be cloned in turn, so the image stays available after the
+	// process which published it is gone.
+	void* address;
+	fArea = clone_area(name, &address, B_ANY_ADDRESS,
+		B_READ_AREA | B_CLONEABLE_AREA, source);
+	if (fArea < 0) {
+		fInitStatus = fArea;
+		return;
+	}
+
+	area_info info;
+	fInitStatus = get_area_info(fArea, &info);
+	if (fInitStatus != B_OK)
+		return;
+
+	fData = (const uint8_t*)address;
+	fSize = info.size;
+}
+
+
+SharedImage::SharedImage(const char* name, const void* data, size_t size)
+	:
+	fData(NULL),
+	fSize(0),
+	fInitStatus(B_OK),
+	fArea(-1)
+{
+	if (size < sizeof(uint32_t)) {
+		fInitStatus = B_BAD_VALUE;
+		return;
+	}
+
+	size_t areaSize = (size + B_PAGE_SIZE - 1) & ~(size_t)(B_PAGE_SIZE - 1);
+
+	void* address;
+	fArea = create_area(name, &address, B_ANY_ADDRESS, areaSize, B_NO_LOCK,
+		B_READ_AREA | B_WRITE_AREA);
+	if (fArea < 0) {
+		fInitStatus = fArea;
+		return;
+	}
+
+	copy_image(address, data, size);
+	fInitStatus = set_area_protection(fArea, B_READ_AREA | B_CLONEABLE_AREA);
+	if (fInitStatus != B_OK)
+		return;
+
+	fData = (const uint8_t*)address;
+	fSize = areaSize;
+}
+
+
+SharedImage::~SharedImage()
+{
+	if (fArea >= 0)
+		delete_area(fArea);
+}
+
+
+/*static*/ void
+SharedImage::Remove(const char* name)
+{
+	// Areas can only be deleted by the teams that created or cloned them,
+	// and deleting the ones of this team would pull them from under the
+	// objects using them
+}
+
+
+#else	// !__HAIKU__
+
+
+/*!	Objects of different users with the same name don't collide, and can't
+	be replaced by each other.
+*/
+static void
+get_object_name(const char* name, char* objectName, size_t size)
+{
+	snprintf(objectName, size, "%s-%u", name, (unsigned)geteuid());
+}
+
+
+SharedImage::SharedImage(const char* name)
+	:
+	fData(NULL),
+	fSize(0),
+	fInitStatus(0)
+{
+	char objectName[NAME_MAX];
+	get_object_name(name, objectName, sizeof(objectName));
+	int fd = shm_open(objectName, O_RDONLY, 0);
+	if (fd < 0) {
+		fInitStatus = errno;
+		return;
+	}
+
+	// Only trust images published the way we publish them
+	struct stat st;
+	void* address = MAP_FAILED;
+	errno = 0;
+	if (fstat(fd, &st) == 0 && st.st_uid == geteuid()
+		&& (st.st_mode & 0077) == 0 && st.st_size > 0)
+		address = mmap(NULL, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+	if (address == MAP_FAILED)
+		fInitStatus = errno != 0 ? errno : EACCES;
+	else {
+		fData = (const uint8_t*)address;
+		fSize = st.st_size;
+	}
+	close(fd);
+}
+
+
+SharedImage::SharedImage(const char* name, const void* data, size_t size)
+	:
+	fData(NULL),
+	fSize(0),
+	fInitStatus(0)
+{
+	if (size < sizeof(uint32_t)) {
+		fInitStatus = EINVAL;
+		return;
+	}
+
+	// Objects outlive processes here, replace any stale one
+	char objectName[NAME_MAX];
+	get_object_name(name, objectName, sizeof(objectName));
+	shm_unlink(objectName);
+	int fd = shm_open(objectName, O_RDWR | O_CREAT | O_EXCL, 0600);
+	if (fd < 0) {
+		fInitStatus = errno;
+		return;
+	}
+
+	void* address = MAP_FAILED;
+	if (ftruncate(fd, size) == 0) {
+		address = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd,
+			0);
+	}
+	if (address == MAP_FAILED) {
+		fInitStatus = errno;
+		shm_unlink(objectName);
+	} else {
+		copy_image(address, data, size);
+		mprotect(address, size, PROT_READ);
+		fData = (const uint8_t*)address;
+		fSize = size;
+	}
+	close(fd);
+}
+
+
+SharedImage::~SharedImage()
+{
+	if (fData != NULL)
+		munmap((void*)fData, fSize);
+}
+
+
+/*static*/ void
+SharedImage::Remove(const char* name)
+{
+	char objectName[NAME_MAX];
+	get_object_name(name, objectName, sizeof(objectName));
+	shm_unlink(objectName);
+}
+
+
+#endif	// !__HAIKU__
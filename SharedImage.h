@@ -0,0 +1,65 @@
+/*
+ * Copyright 2026, Adrien Destugues, pulkomandy@pulkomandy.tk.
+ * Distributed under the terms of the MIT License.
+ */
+#ifndef _SHARED_IMAGE_H_
+#define _SHARED_IMAGE_H_
+
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __HAIKU__
+#	include <OS.h>
+#endif
+
+
+namespace BPrivate {
+
+
+/*	Read-only block of memory shared between processes under a name. On
+ *	Haiku this is a cloneable area, elsewhere a POSIX shared memory object.
+ *
+ *	The first constructor attaches to an existing image, the second publishes
+ *	a new one with the given content. A Haiku area goes away with the object
+ *	that published it, but processes that attached to it keep their clone.
+ *
+ *	Shared memory objects outlive processes, so they are private to the
+ *	user who published them, and only images of that user are attached to.
+ *	Outdated ones have to be removed explicitly.
+ */
+class SharedImage {
+	public:
+		SharedImage(const char* name);
+		SharedImage(const char* name, const void* data, size_t size);
+		~SharedImage();
+
+		static void Remove(const char* name);
+			// Unpublishes an image, processes attached to it keep it. This
+			// does nothing for Haiku areas, which only go away with the
+			// objects using them: users that need outdated images to be
+			// ignored must give new ones another name.
+
+		int InitCheck() const { return fInitStatus; }
+			// 0 on success, an error code otherwise
+
+		const uint8_t* Data() const { return fData; }
+		size_t Size() const { return fSize; }
+
+	private:
+		SharedImage(const SharedImage&);
+		SharedImage& operator=(const SharedImage&);
+
+		const uint8_t*	fData;
+		size_t			fSize;
+		int				fInitStatus;
+#ifdef __HAIKU__
+		area_id			fArea;
+#endif
+};
+
+
+} // namespace BPrivate
+
+
+#endif /* _SHARED_IMAGE_H_ */
@@ -0,0 +1,734 @@
+/*
+ * Copyright 2026, Adrien Destugues, pulkomandy@pulkomandy.tk.
+ * Distributed under the terms of the MIT License.
+ */
+
+#include "StringTable.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#include <algorithm>
+#include <new>
+#include <system_error>
+#include <thread>
+
+
+using BPrivate::IDStringTable;
+
+
+const uint32_t IDStringTable::kNoEntry;
+const uint32_t IDStringTable::kSlotDisplacement;
+const uint32_t IDStringTable::kImageMagic;
+
+static const uint32_t kMinHashedEntries = 64;
+	// sparse tables smaller than that use a binary search
+static const uint32_t kHashBucketSize = 4;
+	// average number of entries per bucket of the perfect hash
+static const uint32_t kMaxDisplacement = 1 << 16;
+static const uint32_t kHashSeeds = 8;
+	// attempts at building the perfect hash before giving up
+
+
+static inline uint8_t*
+copy_table(uint8_t* target, const void* table, size_t size)
+{
+	// Empty tables may have no address at all
+	if (size > 0)
+		memcpy(target, table, size);
+	return target + size;
+}
+
+
+static inline uint32_t
+hash_id(uint32_t id, uint32_t seed)
+{
+	// 64 bit finalizer of MurmurHash3, over both the ID and the seed
+	uint64_t key = ((uint64_t)seed << 32) | id;
+	key ^= key >> 33;
+	key *= 0xff51afd7ed558ccdULL;
+	key ^= key >> 33;
+	key *= 0xc4ceb9fe1a85ec53ULL;
+	key ^= key >> 33;
+	return (uint32_t)key;
+}
+
+
+static inline uint32_t
+hash_range(uint32_t hash, uint32_t range)
+{
+	// Maps the hash to [0, range) without a division
+	return ((uint64_t)hash * range) >> 32;
+}
+
+
+IDStringTable::IDStringTable()
+	:
+	fFirstID(0),
+	fHashSeed(0),
+	fFingerprint(0),
+	fArena(NULL),
+	fArenaSize(0),
+	fArenaUsed(0),
+	fSource(NULL),
+	fLazy(false),
+	fParallelThreshold(0),
+	fDecoder(NULL),
+	fDecoded(NULL),
+	fDecodedCount(0),
+	fEntryTable(NULL),
+	fEntryCount(0),
+	fDirectTable(NULL),
+	fDirectCount(0),
+	fDisplacementTable(NULL),
+	fSlotTable(NULL),
+	fBucketCount(0),
+	fStrings(NULL),
+	fStringsSize(0)
+{
+}
+
+
+IDStringTable::~IDStringTable()
+{
+	MakeEmpty();
+}
+
+
+void
+IDStringTable::MakeEmpty()
+{
+	if (fDecoded != NULL) {
+		for (size_t i = 0; i < fEntryCount; i++)
+			free(fDecoded[i].load(std::memory_order_relaxed));
+		delete[] fDecoded;
+		fDecoded = NULL;
+	}
+
+	fEntries.clear();
+	fDirect.clear();
+	fFirstID = 0;
+	fDisplacements.clear();
+	fSlots.clear();
+	fHashSeed = 0;
+	fFingerprint = 0;
+
+	free(fArena);
+	fArena = NULL;
+	fArenaSize = 0;
+	fArenaUsed = 0;
+
+	fSource = NULL;
+	fLazy = false;
+	fDecoder = NULL;
+	fDecodedCount = 0;
+
+	_UpdateViews();
+}
+
+
+void
+IDStringTable::Swap(IDStringTable& other)
+{
+	fEntries.swap(other.fEntries);
+	fDirect.swap(other.fDirect);
+	std::swap(fFirstID, other.fFirstID);
+	fDisplacements.swap(other.fDisplacements);
+	fSlots.swap(other.fSlots);
+	std::swap(fHashSeed, other.fHashSeed);
+	std::swap(fFingerprint, other.fFingerprint);
+	std::swap(fArena, other.fArena);
+	std::swap(fArenaSize, other.fArenaSize);
+	std::swap(fArenaUsed, other.fArenaUsed);
+	std::swap(fSource, other.fSource);
+	std::swap(fLazy, other.fLazy);
+	std::swap(fParallelThreshold, other.fParallelThreshold);
+	std::swap(fDecoder, other.fDecoder);
+	std::swap(fDecoded, other.fDecoded);
+	fDecodedCount = other.fDecodedCount.exchange(fDecodedCount);
+	std::swap(fEntryTable, other.fEntryTable);
+	std::swap(fEntryCount, other.fEntryCount);
+	std::swap(fDirectTable, other.fDirectTable);
+	std::swap(fDirectCount, other.fDirectCount);
+	std::swap(fDisplacementTable, other.fDisplacementTable);
+	std::swap(fSlotTable, other.fSlotTable);
+	std::swap(fBucketCount, other.fBucketCount);
+	std::swap(fStrings, other.fStrings);
+	std::swap(fStringsSize, other.fStringsSize);
+}
+
+
+void
+IDStringTable::SetDecoder(const Decoder* decoder)
+{
+	fDecoder = decoder;
+}
+
+
+void
+IDStringTable::SetSource(const char* source, bool lazy)
+{
+	fSource = source;
+	fLazy = lazy;
+}
+
+
+void
+IDStringTable::SetParallelThreshold(size_t entries)
+{
+	fParallelThreshold = entries;
+}
+
+
+bool
+IDStringTable::Reserve(size_t size)
+{
+	if (size <= fArenaSize)
+		return true;
+	if (size >= UINT32_MAX)
+		return false;
+
+	char* arena = (char*)realloc(fArena, size);
+	if (arena == NULL)
+		return false;
+
+	fArena = arena;
+	fArenaSize = size;
+	return true;
+}
+
+
+bool
+IDStringTable::Add(uint32_t id, const char* string, size_t length)
+{
+	if (fSource != NULL) {
+		// Only remember where the string is, it is decoded later
+		Entry entry = { id, (uint32_t)(string - fSource), (uint32_t)length };
+		try {
+			fEntries.push_back(entry);
+		} catch (const std::bad_alloc&) {
+			return false;
+		}
+		return true;
+	}
+
+	size_t maxLength = fDecoder != NULL
+		? fDecoder->MaxDecodedLength(length) : length;
+	size_t needed = fArenaUsed + maxLength + 1;
+	if (needed > fArenaSize && !Reserve(std::max(needed, fArenaSize * 2)))
+		return false;
+
+	char* target = fArena + fArenaUsed;
+	if (fDecoder != NULL)
+		length = fDecoder->Decode(string, length, target);
+	else
+		memcpy(target, string, length);
+	target[length] = '\0';
+
+	Entry entry = { id, (uint32_t)fArenaUsed, (uint32_t)length };
+	try {
+		fEntries.push_back(entry);
+	} catch (const std::bad_alloc&) {
+		return false;
+	}
+
+	fArenaUsed += length + 1;
+	return true;
+}
+
+
+bool
+IDStringTable::Finish()
+{
+	fDirect.clear();
+	fFirstID = 0;
+	fDisplacements.clear();
+	fSlots.clear();
+	fHashSeed = 0;
+	fFingerprint = 0;
+
+	if (fEntries.empty()) {
+		fSource = NULL;
+		_UpdateViews();
+		return true;
+	}
+
+	// Keep the last occurence of duplicate IDs, like SetString() would.
+	// The fingerprint is computed in the same pass.
+	std::stable_sort(fEntries.begin(), fEntries.end(), _CompareEntries);
+	size_t count = 0;
+	uint32_t fingerprint = 0;
+	for (size_t i = 0; i < fEntries.size(); i++) {
+		if (count > 0 && fEntries[count - 1].id == fEntries[i].id)
+			count--;
+		else
+			fingerprint += fEntries[i].id;
+		fEntries[count++] = fEntries[i];
+	}
+	fEntries.resize(count);
+	fFingerprint = fingerprint;
+
+	if (fSource != NULL && fLazy) {
+		fDecoded = new(std::nothrow) std::atomic<char*>[count];
+		if (fDecoded == NULL) {
+			fEntries.clear();
+			_UpdateViews();
+			return false;
+		}
+		for (size_t i = 0; i < count; i++)
+			fDecoded[i].store(NULL, std::memory_order_relaxed);
+	} else {
+		if (fSource != NULL && !_DecodeAll()) {
+			fEntries.clear();
+			_UpdateViews();
+			return false;
+		}
+		fDecodedCount = count;
+	}
+
+	// Give back what was reserved but not used. This shrinks the block in
+	// place, the offsets stay valid anyway.
+	if (fArenaUsed < fArenaSize) {
+		char* arena = (char*)realloc(fArena, fArenaUsed);
+		if (arena != NULL || fArenaUsed == 0) {
+			fArena = arena;
+			fArenaSize = fArenaUsed;
+		}
+	}
+
+	uint64_t range = (uint64_t)fEntries.back().id - fEntries.front().id + 1;
+	if (range <= 2 * (uint64_t)count) {
+		try {
+			fDirect.assign(range, kNoEntry);
+			fFirstID = fEntries.front().id;
+			for (size_t i = 0; i < count; i++)
+				fDirect[fEntries[i].id - fFirstID] = i;
+		} catch (const std::bad_alloc&) {
+			// The binary search still works
+		}
+	}
+
+	if (fDirect.empty() && count >= kMinHashedEntries) {
+		// If this fails, the binary search still works
+		_BuildHash();
+	}
+
+	_UpdateViews();
+	return true;
+}
+
+
+bool
+IDStringTable::Freeze()
+{
+	if (fDecoded == NULL)
+		return true;
+
+	for (size_t i = 0; i < fEntryCount; i++) {
+		if (_Decode(i) == NULL)
+			return false;
+	}
+	return true;
+}
+
+
+size_t
+IDStringTable::ImageSize() const
+{
+	size_t slotCount = fBucketCount > 0 ? fEntryCount : 0;
+	return sizeof(ImageHeader) + fEntryCount * sizeof(Entry)
+		+ (fDirectCount + fBucketCount + slotCount) * sizeof(uint32_t)
+		+ fStringsSize;
+}
+
+
+void
+IDStringTable::WriteImage(void* buffer) const
+{
+	ImageHeader header = { kImageMagic, fEntryCount, fFirstID, fDirectCount,
+		fBucketCount, fHashSeed, fStringsSize };
+	size_t slotCount = fBucketCount > 0 ? fEntryCount : 0;
+
+	uint8_t* target = (uint8_t*)buffer;
+	memcpy(target, &header, sizeof(header));
+	target += sizeof(header);
+	target = copy_table(target, fEntryTable, fEntryCount * sizeof(Entry));
+	target = copy_table(target, fDirectTable,
+		fDirectCount * sizeof(uint32_t));
+	target = copy_table(target, fDisplacementTable,
+		fBucketCount * sizeof(uint32_t));
+	target = copy_table(target, fSlotTable, slotCount * sizeof(uint32_t));
+	copy_table(target, fStrings, fStringsSize);
+}
+
+
+bool
+IDStringTable::SetImage(const void* image, size_t size)
+{
+	ImageHeader header;
+	if (size < sizeof(header) || ((uintptr_t)image & 3) != 0)
+		return false;
+	memcpy(&header, image, sizeof(header));
+
+	// The image may be followed by some padding. Lookups use at most one
+	// index, and the perfect hash needs entries to point to.
+	uint64_t slotCount = header.bucketCount > 0 ? header.entryCount : 0;
+	if (header.magic != kImageMagic
+		|| (header.bucketCount > 0 && header.entryCount == 0)
+		|| (header.bucketCount > 0 && header.directCount > 0)
+		|| size < sizeof(header) + (uint64_t)header.entryCount * sizeof(Entry)
+			+ ((uint64_t)header.directCount + header.bucketCount + slotCount)
+				* sizeof(uint32_t)
+			+ header.stringsSize)
+		return false;
+
+	MakeEmpty();
+
+	const uint8_t* data = (const uint8_t*)image + sizeof(header);
+	fEntryTable = (const Entry*)data;
+	fEntryCount = header.entryCount;
+	data += fEntryCount * sizeof(Entry);
+	fDirectTable = (const uint32_t*)data;
+	fDirectCount = header.directCount;
+	data += fDirectCount * sizeof(uint32_t);
+	fDisplacementTable = (const uint32_t*)data;
+	fBucketCount = header.bucketCount;
+	data += fBucketCount * sizeof(uint32_t);
+	fSlotTable = (const uint32_t*)data;
+	data += slotCount * sizeof(uint32_t);
+	fStrings = (const char*)data;
+	fStringsSize = header.stringsSize;
+	fFirstID = header.firstID;
+	fHashSeed = header.hashSeed;
+	fDecodedCount = fEntryCount;
+
+	// Don't trust the image more than a catalog file. The fingerprint is
+	// computed in the same pass.
+	for (uint32_t i = 0; i < fEntryCount; i++) {
+		fFingerprint += fEntryTable[i].id;
+		if ((uint64_t)fEntryTable[i].offset + fEntryTable[i].length
+				>= fStringsSize
+			|| fStrings[fEntryTable[i].offset + fEntryTable[i].length] != '\0'
+			|| (i > 0 && fEntryTable[i - 1].id >= fEntryTable[i].id)) {
+			MakeEmpty();
+			return false;
+		}
+	}
+	for (uint32_t i = 0; i < fDirectCount; i++) {
+		if (fDirectTable[i] != kNoEntry && fDirectTable[i] >= fEntryCount) {
+			MakeEmpty();
+			return false;
+		}
+	}
+	for (uint32_t i = 0; i < fBucketCount; i++) {
+		if ((fDisplacementTable[i] & kSlotDisplacement) != 0
+			&& (fDisplacementTable[i] & ~kSlotDisplacement) >= fEntryCount) {
+			MakeEmpty();
+			return false;
+		}
+	}
+	for (uint32_t i = 0; i < slotCount; i++) {
+		if (fSlotTable[i] >= fEntryCount) {
+			MakeEmpty();
+			return false;
+		}
+	}
+	return true;
+}
+
+
+const char*
+IDStringTable::Lookup(uint32_t id) const
+{
+	uint32_t index = _FindEntry(id);
+	if (index == kNoEntry)
+		return NULL;
+
+	return StringAt(index);
+}
+
+
+const char*
+IDStringTable::StringAt(size_t index) const
+{
+	if (fDecoded != NULL)
+		return _Decode(index);
+	return fStrings + fEntryTable[index].offset;
+}
+
+
+size_t
+IDStringTable::CountDecodedItems() const
+{
+	return fDecodedCount.load(std::memory_order_relaxed);
+}
+
+
+void
+IDStringTable::_UpdateViews()
+{
+	fEntryTable = fEntries.empty() ? NULL : &fEntries[0];
+	fEntryCount = fEntries.size();
+	fDirectTable = fDirect.empty() ? NULL : &fDirect[0];
+	fDirectCount = fDirect.size();
+	fDisplacementTable = fDisplacements.empty() ? NULL : &fDisplacements[0];
+	fSlotTable = fSlots.empty() ? NULL : &fSlots[0];
+	fBucketCount = fDisplacements.size();
+	fStrings = fArena;
+	fStringsSize = fArenaUsed;
+}
+
+
+/*!	Decodes all entries from the source into the arena. Each worker thread
+	gets a contiguous range of entries, and a region of the arena large
+	enough for the longest possible result. Once they are done, the regions
+	are moved back to back to remove the unused space between them.
+*/
+bool
+IDStringTable::_DecodeAll()
+{
+	size_t count = fEntries.size();
+	size_t threads = 1;
+	if (fParallelThreshold > 0 && count >= fParallelThreshold) {
+		threads = std::min((size_t)std::thread::hardware_concurrency(),
+			count * 2 / fParallelThreshold);
+		threads = std::max(threads, (size_t)1);
+	}
+
+	std::vector<size_t> first(threads + 1);
+	std::vector<size_t> start(threads + 1);
+	std::vector<size_t> end(threads);
+	size_t size = fArenaUsed;
+	for (size_t i = 0; i < threads; i++) {
+		first[i] = count * i / threads;
+		start[i] = size;
+		for (size_t j = first[i]; j < count * (i + 1) / threads; j++)
+			size += fDecoder->MaxDecodedLength(fEntries[j].length) + 1;
+	}
+	first[threads] = count;
+	start[threads] = size;
+
+	if (!Reserve(size))
+		return false;
+
+	// With the room reserved up front, adding a worker never reallocates
+	// the vector, so only starting its thread can fail.
+	std::vector<std::thread> workers;
+	try {
+		workers.reserve(threads - 1);
+	} catch (const std::bad_alloc&) {
+	}
+	for (size_t i = 1; i < threads; i++) {
+		if (workers.capacity() >= threads - 1) {
+			try {
+				workers.emplace_back(&IDStringTable::_DecodeRange, this,
+					first[i], first[i + 1], start[i], &end[i]);
+				continue;
+			} catch (const std::system_error&) {
+			}
+		}
+		// Not enough resources for another thread, do it ourselves
+		_DecodeRange(first[i], first[i + 1], start[i], &end[i]);
+	}
+	_DecodeRange(first[0], first[1], start[0], &end[0]);
+	for (size_t i = 0; i < workers.size(); i++)
+		workers[i].join();
+
+	size_t used = end[0];
+	for (size_t i = 1; i < threads; i++) {
+		size_t shift = start[i] - used;
+		memmove(fArena + used, fArena + start[i], end[i] - start[i]);
+		for (size_t j = first[i]; j < first[i + 1]; j++)
+			fEntries[j].offset -= shift;
+		used += end[i] - start[i];
+	}
+
+	fArenaUsed = used;
+	fSource = NULL;
+	return true;
+}
+
+
+void
+IDStringTable::_DecodeRange(size_t first, size_t last, size_t offset,
+	size_t* _end)
+{
+	for (size_t i = first; i < last; i++) {
+		Entry& entry = fEntries[i];
+		char* target = fArena + offset;
+		size_t length = fDecoder->Decode(fSource + entry.offset, entry.length,
+			target);
+		target[length] = '\0';
+
+		entry.offset = offset;
+		entry.length = length;
+		offset += length + 1;
+	}
+	*_end = offset;
+}
+
+
+/*!	Builds a minimal perfect hash of the IDs in fEntries. Entries are spread
+	in buckets by a first hash, then for each bucket, largest first, a
+	displacement is searched so that a second hash seeded with it sends all
+	of its entries to free slots. There are as many slots as entries.
+	Buckets with a single entry just get the first free slot.
+*/
+bool
+IDStringTable::_BuildHash()
+{
+	try {
+		for (uint32_t seed = 0; seed < kHashSeeds; seed++) {
+			if (_BuildHash(seed * 0x9e3779b9))
+				return true;
+		}
+	} catch (const std::bad_alloc&) {
+	}
+
+	fDisplacements.clear();
+	fSlots.clear();
+	fHashSeed = 0;
+	return false;
+}
+
+
+bool
+IDStringTable::_BuildHash(uint32_t seed)
+{
+	uint32_t count = fEntries.size();
+	uint32_t bucketCount = (count + kHashBucketSize - 1) / kHashBucketSize;
+
+	// Group the entries by bucket
+	std::vector<uint32_t> bucketStart(bucketCount + 1, 0);
+	std::vector<uint32_t> entryBucket(count);
+	for (uint32_t i = 0; i < count; i++) {
+		entryBucket[i] = hash_range(hash_id(fEntries[i].id, seed),
+			bucketCount);
+		bucketStart[entryBucket[i] + 1]++;
+	}
+	for (uint32_t i = 0; i < bucketCount; i++)
+		bucketStart[i + 1] += bucketStart[i];
+
+	std::vector<uint32_t> bucketEntries(count);
+	std::vector<uint32_t> fill(bucketStart.begin(), bucketStart.end() - 1);
+	for (uint32_t i = 0; i < count; i++)
+		bucketEntries[fill[entryBucket[i]]++] = i;
+
+	std::vector<uint32_t> buckets(bucketCount);
+	for (uint32_t i = 0; i < bucketCount; i++)
+		buckets[i] = i;
+	std::stable_sort(buckets.begin(), buckets.end(),
+		[&bucketStart](uint32_t a, uint32_t b) {
+			return bucketStart[a + 1] - bucketStart[a]
+				> bucketStart[b + 1] - bucketStart[b];
+		});
+
+	fDisplacements.assign(bucketCount, 0);
+	fSlots.assign(count, kNoEntry);
+	std::vector<uint32_t> candidates;
+	uint32_t nextFree = 0;
+
+	for (uint32_t i = 0; i < bucketCount; i++) {
+		uint32_t bucket = buckets[i];
+		const uint32_t* entries = &bucketEntries[0] + bucketStart[bucket];
+		uint32_t size = bucketStart[bucket + 1] - bucketStart[bucket];
+		if (size == 0)
+			break;
+
+		if (size == 1) {
+			while (fSlots[nextFree] != kNoEntry)
+				nextFree++;
+			fSlots[nextFree] = entries[0];
+			fDisplacements[bucket] = kSlotDisplacement | nextFree;
+			continue;
+		}
+
+		uint32_t displacement = 1;
+		for (; displacement < kMaxDisplacement; displacement++) {
+			candidates.clear();
+			for (uint32_t j = 0; j < size; j++) {
+				uint32_t slot = hash_range(
+					hash_id(fEntries[entries[j]].id, seed + displacement),
+					count);
+				if (fSlots[slot] != kNoEntry)
+					break;
+				// Claim it already, so entries of the same bucket don't
+				// collide either
+				fSlots[slot] = entries[j];
+				candidates.push_back(slot);
+			}
+			if (candidates.size() == size)
+				break;
+
+			for (size_t j = 0; j < candidates.size(); j++)
+				fSlots[candidates[j]] = kNoEntry;
+		}
+		if (displacement == kMaxDisplacement)
+			return false;
+
+		fDisplacements[bucket] = displacement;
+	}
+
+	fHashSeed = seed;
+	return true;
+}
+
+
+uint32_t
+IDStringTable::_FindEntry(uint32_t id) const
+{
+	if (fDirectCount > 0) {
+		uint32_t index = id - fFirstID;
+		if (index >= fDirectCount)
+			return kNoEntry;
+		return fDirectTable[index];
+	}
+
+	if (fBucketCount > 0) {
+		uint32_t displacement = fDisplacementTable[
+			hash_range(hash_id(id, fHashSeed), fBucketCount)];
+		uint32_t slot = (displacement & kSlotDisplacement) != 0
+			? displacement & ~kSlotDisplacement
+			: hash_range(hash_id(id, fHashSeed + displacement), fEntryCount);
+		uint32_t index = fSlotTable[slot];
+		return fEntryTable[index].id == id ? index : kNoEntry;
+	}
+
+	Entry key = { id, 0, 0 };
+	const Entry* end = fEntryTable + fEntryCount;
+	const Entry* found = std::lower_bound(fEntryTable, end, key,
+		_CompareEntries);
+	if (found != end && found->id == id)
+		return found - fEntryTable;
+	return kNoEntry;
+}
+
+
+const char*
+IDStringTable::_Decode(uint32_t index) const
+{
+	char* string = fDecoded[index].load(std::memory_order_acquire);
+	if (string != NULL)
+		return string;
+
+	const Entry& entry = fEntryTable[index];
+	string = (char*)malloc(fDecoder->MaxDecodedLength(entry.length) + 1);
+	if (string == NULL)
+		return NULL;
+
+	size_t length = fDecoder->Decode(fSource + entry.offset, entry.length,
+		string);
+	string[length] = '\0';
+
+	// Another thread may have decoded the same string in the meantime, keep
+	// whichever was published first.
+	char* expected = NULL;
+	if (!fDecoded[index].compare_exchange_strong(expected, string,
+			std::memory_order_acq_rel)) {
+		free(string);
+		return expected;
+	}
+
+	fDecodedCount.fetch_add(1, std::memory_order_relaxed);
+	return string;
+}
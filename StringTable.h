@@ -0,0 +1,188 @@
+/*
+ * Copyright 2026, Adrien Destugues, pulkomandy@pulkomandy.tk.
+ * Distributed under the terms of the MIT License.
+ */
+#ifndef _STRING_TABLE_H_
+#define _STRING_TABLE_H_
+
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <atomic>
+#include <vector>
+
+
+namespace BPrivate {
+
+
+/*	Storage for catalog strings indexed by their numeric ID. Amiga catalog IDs
+ *	are usually dense and ascending, so they are looked up in a direct array
+ *	whenever the ID range is at least half full. Larger sparse sets of IDs
+ *	get a minimal perfect hash built for them instead (hash and displace, as
+ *	in CHD), so a lookup still takes a single probe in the sorted entries.
+ *	Small ones just use a binary search. Either way, there is no allocation
+ *	per entry in the index.
+ *
+ *	The strings themselves are stored one after the other in a single arena,
+ *	and entries only keep their offset in it. Reserve() should be called
+ *	with the expected total size before adding strings, so the whole table
+ *	needs a single allocation.
+ *
+ *	When a decoder is set, Add() takes raw strings from the catalog file and
+ *	the decoder writes them straight into the arena, so there is no scratch
+ *	buffer and no limit on the length of strings.
+ *
+ *	With SetSource(), Add() only records where the raw string is in the source
+ *	buffer, and decoding is deferred. Lazy tables decode each string the
+ *	first time it is looked up, so the source buffer must stay valid as long
+ *	as the table. Other tables decode all strings in Finish(), which splits
+ *	the work between several threads for tables with at least as many
+ *	entries as the parallel threshold; the source buffer is then no longer
+ *	needed.
+ *
+ *	The table is filled with Add(), then Finish() builds the index. Lookups are
+ *	only valid after Finish(), and may be done from several threads. They
+ *	only read the table, except for the first lookup of each string of a
+ *	lazy table. Freeze() decodes whatever is left, after which lookups never
+ *	write anything and can't contend with each other.
+ *
+ *	A finished table that is not lazy can be saved as a flat image, with
+ *	ImageSize() and WriteImage(). SetImage() makes a table use such an image
+ *	in place, for example from a mapped file, which must then stay valid as
+ *	long as the table. The image uses the host byte order.
+ */
+class IDStringTable {
+	public:
+		class Decoder {
+			public:
+				virtual ~Decoder() {}
+
+				virtual size_t MaxDecodedLength(size_t length) const = 0;
+				virtual size_t Decode(const char* string, size_t length,
+					char* target) const = 0;
+					// target has room for MaxDecodedLength(length) bytes,
+					// returns the length actually used
+		};
+
+		IDStringTable();
+		~IDStringTable();
+
+		void MakeEmpty();
+		void Swap(IDStringTable& other);
+
+		void SetDecoder(const Decoder* decoder);
+		void SetSource(const char* source, bool lazy);
+		void SetParallelThreshold(size_t entries);
+			// 0 to always decode on the calling thread
+		bool Reserve(size_t size);
+		bool Add(uint32_t id, const char* string, size_t length);
+			// a later string with the same ID replaces the earlier one
+		bool Finish();
+			// returns false if there was not enough memory
+		bool Freeze();
+			// decodes all strings of a lazy table, returns false if there
+			// was not enough memory
+
+		size_t ImageSize() const;
+		void WriteImage(void* buffer) const;
+		bool SetImage(const void* image, size_t size);
+
+		const char* Lookup(uint32_t id) const;
+		bool Contains(uint32_t id) const
+			{ return _FindEntry(id) != kNoEntry; }
+			// unlike Lookup(), never decodes the string
+		size_t CountItems() const { return fEntryCount; }
+
+		// entries by index, in ascending ID order
+		uint32_t IDAt(size_t index) const { return fEntryTable[index].id; }
+		const char* StringAt(size_t index) const;
+		size_t CountDecodedItems() const;
+
+		uint32_t Fingerprint() const { return fFingerprint; }
+			// same value as HashMapCatalog::ComputeFingerprint() gives for
+			// a catalog holding the same IDs, computed while finishing the
+			// table
+
+	private:
+		IDStringTable(const IDStringTable&);
+		IDStringTable& operator=(const IDStringTable&);
+
+		struct Entry {
+			uint32_t	id;
+			uint32_t	offset;
+				// in the arena, or in the source for lazy tables
+			uint32_t	length;
+		};
+
+		struct ImageHeader {
+			uint32_t	magic;
+			uint32_t	entryCount;
+			uint32_t	firstID;
+			uint32_t	directCount;
+			uint32_t	bucketCount;
+			uint32_t	hashSeed;
+			uint32_t	stringsSize;
+		};
+
+		static const uint32_t kNoEntry = UINT32_MAX;
+		static const uint32_t kSlotDisplacement = 0x80000000;
+			// the displacement is the slot of its single entry
+		static const uint32_t kImageMagic = 'IDST';
+
+		static bool _CompareEntries(const Entry& a, const Entry& b)
+			{ return a.id < b.id; }
+
+		void _UpdateViews();
+		bool _BuildHash();
+		bool _BuildHash(uint32_t seed);
+		bool _DecodeAll();
+		void _DecodeRange(size_t first, size_t last, size_t offset,
+			size_t* _end);
+		uint32_t _FindEntry(uint32_t id) const;
+		const char* _Decode(uint32_t index) const;
+
+		std::vector<Entry>			fEntries;
+			// sorted by ID once the table is finished
+		std::vector<uint32_t>		fDirect;
+			// entry indices by (ID - fFirstID), empty for sparse tables
+		uint32_t					fFirstID;
+		std::vector<uint32_t>		fDisplacements;
+			// one per hash bucket, for sparse tables
+		std::vector<uint32_t>		fSlots;
+			// entry indices by hash slot, as many as entries
+		uint32_t					fHashSeed;
+		uint32_t					fFingerprint;
+			// HashMapCatalog sums the hash of every key, which is the ID
+			// itself for ID-based keys.
+
+		char*						fArena;
+		size_t						fArenaSize;
+		size_t						fArenaUsed;
+
+		const char*					fSource;
+		bool						fLazy;
+		size_t						fParallelThreshold;
+		const Decoder*				fDecoder;
+		std::atomic<char*>*			fDecoded;
+			// one per entry, for lazy tables
+		mutable std::atomic<size_t>	fDecodedCount;
+
+		// What lookups use: either the members above once the table is
+		// finished, or an image given to SetImage()
+		const Entry*				fEntryTable;
+		uint32_t					fEntryCount;
+		const uint32_t*				fDirectTable;
+		uint32_t					fDirectCount;
+		const uint32_t*				fDisplacementTable;
+		const uint32_t*				fSlotTable;
+		uint32_t					fBucketCount;
+		const char*					fStrings;
+		uint32_t					fStringsSize;
+};
+
+
+} // namespace BPrivate
+
+
+#endif /* _STRING_TABLE_H_ */
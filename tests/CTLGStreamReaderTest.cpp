@@ -0,0 +1,351 @@
+/*
+ * Copyright 2026, Adrien Destugues, pulkomandy@pulkomandy.tk.
+ * Distributed under the terms of the MIT License.
+ */
+
+/*	Feeds catalogs to CTLGStreamReader through a pipe written in uneven
+ *	pieces with pauses in between, like slow media would deliver them, and
+ *	checks that it sees the same chunks and strings as the iterators walking
+ *	the whole file in memory, whatever the size of its window.
+ */
+
+
+#include <signal.h>
+
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "CatalogLoader.h"
+#include "CTLGReader.h"
+#include "CTLGWriter.h"
+#include "RandomCatalog.h"
+#include "StringTable.h"
+#include "Test.h"
+
+
+using BPrivate::CTLGChunk;
+using BPrivate::CTLGChunkIterator;
+using BPrivate::CTLGStreamReader;
+using BPrivate::CTLGString;
+using BPrivate::CTLGStringIterator;
+using BPrivate::CTLGWriter;
+using BPrivate::generate_random_catalog;
+using BPrivate::IDStringTable;
+using BPrivate::kCTLGCodeSetUTF8;
+using BPrivate::kCTLGMaxEntrySize;
+using BPrivate::kCTLGMinWindowSize;
+using BPrivate::RandomCatalogShape;
+using BPrivate::read_mapped_catalog;
+using BPrivate::read_streamed_catalog;
+
+
+static const size_t kWindowSizes[] = { 1, 257, 1001, 4096, 65536 };
+	// 1 is rounded up by the reader
+
+
+struct Chunk {
+	uint32_t	id;
+	size_t		size;
+	std::string	data;
+	bool		hasData;
+};
+
+
+struct String {
+	uint32_t	id;
+	std::string	string;
+
+	bool operator==(const String& other) const
+		{ return id == other.id && string == other.string; }
+};
+
+
+/*!	Writes the buffer to the pipe in pieces of 1 to \a maxWrite bytes,
+	pausing after every few KiB, then closes it. Only \a size bytes are
+	written, to simulate a truncated file.
+*/
+static void
+write_throttled(int fd, const std::vector<uint8_t>& buffer, size_t size,
+	size_t maxWrite, uint32_t seed)
+{
+	std::mt19937 random(seed);
+	std::uniform_int_distribution<size_t> pieceSize(1, maxWrite);
+	std::uniform_int_distribution<size_t> pauseAfter(1, 8192);
+
+	size_t written = 0;
+	size_t nextPause = pauseAfter(random);
+	while (written < size) {
+		size_t piece = std::min(pieceSize(random), size - written);
+		ssize_t result = write(fd, &buffer[written], piece);
+		if (result <= 0)
+			break;
+		written += result;
+
+		if (written >= nextPause) {
+			usleep(100);
+			nextPause = written + pauseAfter(random);
+		}
+	}
+	close(fd);
+}
+
+
+static void
+read_in_memory(const std::vector<uint8_t>& buffer, size_t windowSize,
+	std::vector<Chunk>& chunks, std::vector<String>& strings)
+{
+	CTLGChunkIterator iterator(&buffer[0], buffer.size());
+	CTLGChunk chunk;
+	while (iterator.Next(chunk)) {
+		// The stream reader only gives the data of chunks fitting in its
+		// window
+		Chunk entry = { chunk.id, chunk.size, "", false };
+		if (chunk.id != 'STRS' && chunk.size <= std::max(windowSize,
+				kCTLGMinWindowSize)) {
+			entry.data.assign((const char*)chunk.data, chunk.size);
+			entry.hasData = true;
+		}
+		chunks.push_back(entry);
+
+		if (chunk.id == 'STRS') {
+			CTLGStringIterator stringIterator(chunk);
+			CTLGString string;
+			while (stringIterator.Next(string)) {
+				String entry = { string.id,
+					std::string(string.string, string.length) };
+				strings.push_back(entry);
+			}
+			CHECK(stringIterator.IsValid());
+		}
+	}
+	CHECK(iterator.IsValid());
+}
+
+
+/*!	Reads the catalog from a pipe written by another thread. Returns whether
+	the reader found the file valid.
+*/
+static bool
+read_from_pipe(const std::vector<uint8_t>& buffer, size_t size,
+	size_t windowSize, size_t maxWrite, std::vector<Chunk>& chunks,
+	std::vector<String>& strings)
+{
+	int fds[2];
+	if (pipe(fds) != 0) {
+		CHECK(false);
+		return false;
+	}
+	std::thread writer(write_throttled, fds[1], std::cref(buffer), size,
+		maxWrite, (uint32_t)(windowSize + maxWrite));
+
+	bool valid;
+	{
+		CTLGStreamReader reader(fds[0], windowSize);
+		CTLGChunk chunk;
+		while (reader.NextChunk(chunk)) {
+			Chunk entry = { chunk.id, chunk.size, "", chunk.data != NULL };
+			if (chunk.data != NULL)
+				entry.data.assign((const char*)chunk.data, chunk.size);
+			chunks.push_back(entry);
+
+			CTLGString string;
+			while (reader.NextString(string)) {
+				String entry = { string.id,
+					std::string(string.string, string.length) };
+				strings.push_back(entry);
+			}
+		}
+		valid = reader.IsValid();
+	}
+
+	// Let the writer finish if the reader gave up early
+	char discard[4096];
+	while (read(fds[0], discard, sizeof(discard)) > 0)
+		;
+	close(fds[0]);
+	writer.join();
+	return valid;
+}
+
+
+static void
+check_catalog(const RandomCatalogShape& shape,
+	const char* version = "x-vnd.Test-StreamReader")
+{
+	std::vector<uint8_t> buffer;
+	uint32_t fingerprint;
+	CHECK(generate_random_catalog(shape, version, "polski", buffer,
+		fingerprint) == 0);
+
+	IDStringTable expectedTable;
+	std::string expectedVersion, expectedLanguage;
+	CHECK(read_mapped_catalog(&buffer[0], buffer.size(), expectedTable, false,
+		expectedVersion, expectedLanguage) == 0);
+	CHECK(expectedTable.Finish());
+
+	for (size_t i = 0; i < sizeof(kWindowSizes) / sizeof(kWindowSizes[0]);
+			i++) {
+		size_t windowSize = kWindowSizes[i];
+		std::vector<Chunk> expectedChunks;
+		std::vector<String> expectedStrings;
+		read_in_memory(buffer, windowSize, expectedChunks, expectedStrings);
+
+		// Writes smaller and larger than the window
+		const size_t maxWrites[] = { 7, 3000 };
+		for (size_t j = 0; j < 2; j++) {
+			std::vector<Chunk> chunks;
+			std::vector<String> strings;
+			CHECK(read_from_pipe(buffer, buffer.size(), windowSize,
+				maxWrites[j], chunks, strings));
+
+			CHECK(chunks.size() == expectedChunks.size());
+			for (size_t k = 0; k < chunks.size() && k < expectedChunks.size();
+					k++) {
+				CHECK(chunks[k].id == expectedChunks[k].id);
+				CHECK(chunks[k].size == expectedChunks[k].size);
+				CHECK(chunks[k].hasData == expectedChunks[k].hasData);
+				CHECK(chunks[k].data == expectedChunks[k].data);
+			}
+			CHECK(strings == expectedStrings);
+		}
+
+		// A file cut short is never taken for a complete one
+		std::vector<Chunk> chunks;
+		std::vector<String> strings;
+		CHECK(!read_from_pipe(buffer, buffer.size() * 2 / 3, windowSize, 3000,
+			chunks, strings));
+		CHECK(strings.size() < expectedStrings.size()
+			|| expectedStrings.empty());
+
+		// What the add-on does with the reader, converting the strings
+		int fds[2];
+		CHECK(pipe(fds) == 0);
+		std::thread writer(write_throttled, fds[1], std::cref(buffer),
+			buffer.size(), 500, (uint32_t)windowSize);
+		IDStringTable table;
+		std::string version, language;
+		CHECK(read_streamed_catalog(fds[0], table, version, language,
+			windowSize) == 0);
+		close(fds[0]);
+		writer.join();
+
+		CHECK(table.Finish());
+		// Chunks larger than the window are skipped
+		if (expectedVersion.size() < std::max(windowSize, kCTLGMinWindowSize))
+			CHECK(version == expectedVersion);
+		else
+			CHECK(version.empty());
+		CHECK(language == expectedLanguage);
+		CHECK(table.CountItems() == expectedTable.CountItems());
+		for (size_t k = 0; k < table.CountItems()
+				&& k < expectedTable.CountItems(); k++) {
+			CHECK(table.IDAt(k) == expectedTable.IDAt(k));
+			CHECK(strcmp(table.StringAt(k), expectedTable.StringAt(k)) == 0);
+		}
+	}
+}
+
+
+static int
+read_streamed(const std::vector<uint8_t>& buffer, IDStringTable& table)
+{
+	int fds[2];
+	CHECK(pipe(fds) == 0);
+	std::thread writer(write_throttled, fds[1], std::cref(buffer),
+		buffer.size(), 3000, 1);
+
+	std::string version, language;
+	int error = read_streamed_catalog(fds[0], table, version, language,
+		4096);
+
+	char discard[4096];
+	while (read(fds[0], discard, sizeof(discard)) > 0)
+		;
+	close(fds[0]);
+	writer.join();
+	return error;
+}
+
+
+/*!	Entries get a larger buffer than the window only up to a limit, since
+	their size comes from the file.
+*/
+static void
+check_oversized_entries()
+{
+	// A string just below the limit still works, and the reader goes back
+	// to its window for the next ones
+	std::string large(kCTLGMaxEntrySize - 16, 'x');
+	CTLGWriter writer("x-vnd.Test-StreamReader", "polski");
+	writer.SetCodeSet(kCTLGCodeSetUTF8);
+	CHECK(writer.AddString(1, large.data(), large.size()));
+	CHECK(writer.AddString(2, "after", 5));
+	std::vector<uint8_t> buffer;
+	CHECK(writer.Flatten(buffer));
+
+	IDStringTable table;
+	CHECK(read_streamed(buffer, table) == 0);
+	CHECK(table.Finish());
+	CHECK(table.CountItems() == 2);
+	CHECK(table.Lookup(1) != NULL && table.Lookup(1) == large);
+	CHECK(table.Lookup(2) != NULL && strcmp(table.Lookup(2), "after") == 0);
+
+	// A larger one makes the file invalid, though the whole file can still
+	// be read in memory
+	large.append(32, 'y');
+	CHECK(writer.AddString(1, large.data(), large.size()));
+	CHECK(writer.Flatten(buffer));
+
+	IDStringTable tooLarge;
+	CHECK(read_streamed(buffer, tooLarge) == EINVAL);
+	IDStringTable mapped;
+	std::string version, language;
+	CHECK(read_mapped_catalog(&buffer[0], buffer.size(), mapped, false,
+		version, language) == 0);
+
+	// Sizes claimed by a corrupt file are not trusted either
+	const uint8_t kHeader[] = {
+		'F', 'O', 'R', 'M', 0x7f, 0xff, 0xff, 0xf0, 'C', 'T', 'L', 'G',
+		'S', 'T', 'R', 'S', 0x7f, 0xff, 0xff, 0xe0,
+		0, 0, 0, 1, 0x7f, 0xff, 0xff, 0x00, 'a', 'b', 'c', 0
+	};
+	std::vector<uint8_t> corrupt(kHeader, kHeader + sizeof(kHeader));
+	IDStringTable corruptTable;
+	CHECK(read_streamed(corrupt, corruptTable) == EINVAL);
+}
+
+
+int
+main(int argc, char** argv)
+{
+	// Readers giving up early close the pipe under the writer
+	signal(SIGPIPE, SIG_IGN);
+
+	RandomCatalogShape shape;
+	shape.count = 500;
+	check_catalog(shape);
+
+	// Sparse Latin-1 strings
+	shape.density = 0.1;
+	shape.codeSet = 4;
+	shape.nonASCIIPercent = 30;
+	check_catalog(shape);
+
+	// Strings larger than most windows
+	shape.count = 50;
+	shape.density = 1;
+	shape.minLength = 1000;
+	shape.maxLength = 20000;
+	check_catalog(shape);
+
+	// Nothing but the header chunks, one of them larger than some windows
+	shape.count = 0;
+	check_catalog(shape);
+	check_catalog(shape, std::string(600, 'v').c_str());
+
+	check_oversized_entries();
+
+	return test_result(argv[0]);
+}
@@ -0,0 +1,341 @@
+/*
+ * Copyright 2026, Adrien Destugues, pulkomandy@pulkomandy.tk.
+ * Distributed under the terms of the MIT License.
+ */
+
+/*	Checks that catalogs written by CTLGWriter read back as they were
+ *	written, and that writing back what was read, as the add-on does for
+ *	editors, gives the same file. The layout of the file is checked byte by
+ *	byte.
+ */
+
+
+#include <string>
+#include <vector>
+
+#include "CatalogLoader.h"
+#include "CTLGReader.h"
+#include "CTLGWriter.h"
+#include "StringTable.h"
+#include "Test.h"
+
+
+using BPrivate::add_table_strings;
+using BPrivate::CTLGChunk;
+using BPrivate::CTLGChunkIterator;
+using BPrivate::ctlg_read_uint32;
+using BPrivate::CTLGWriter;
+using BPrivate::IDStringTable;
+using BPrivate::kCTLGCodeSetLatin1;
+using BPrivate::kCTLGCodeSetUTF8;
+using BPrivate::read_mapped_catalog;
+
+
+static const char* kVersion = "x-vnd.Test-CTLGWriter";
+static const char* kLanguage = "deutsch";
+
+
+struct TestString {
+	uint32_t	id;
+	const char*	string;
+};
+
+
+static bool
+read_catalog(const std::vector<uint8_t>& buffer, IDStringTable& table)
+{
+	std::string version, language;
+	if (read_mapped_catalog(&buffer[0], buffer.size(), table, false, version,
+			language) != 0 || !table.Finish())
+		return false;
+
+	CHECK(version == kVersion);
+	CHECK(language == kLanguage);
+	return true;
+}
+
+
+/*!	Writes back what was read from \a buffer, as AmigaCatalog::WriteToFile()
+	does, and checks that it gives the same file and fingerprint.
+*/
+static void
+check_write_back(const std::vector<uint8_t>& buffer, uint32_t fingerprint)
+{
+	IDStringTable table;
+	CHECK(read_catalog(buffer, table));
+	CHECK(table.Fingerprint() == fingerprint);
+
+	CTLGWriter writer(kVersion, kLanguage);
+	CHECK(add_table_strings(writer, table));
+	std::vector<uint8_t> written;
+	CHECK(writer.Flatten(written));
+	CHECK(written == buffer);
+	CHECK(writer.Fingerprint() == fingerprint);
+}
+
+
+/*!	Checks the chunks of a flattened catalog, their size and padding, and
+	returns its code set.
+*/
+static uint32_t
+check_layout(const std::vector<uint8_t>& buffer)
+{
+	CHECK(buffer.size() >= 12 && (buffer.size() & 1) == 0);
+	CHECK(ctlg_read_uint32(&buffer[0]) == 'FORM');
+	CHECK(ctlg_read_uint32(&buffer[4]) == buffer.size() - 8);
+	CHECK(ctlg_read_uint32(&buffer[8]) == 'CTLG');
+
+	const uint32_t kChunks[] = { 'FVER', 'LANG', 'CSET', 'STRS' };
+	uint32_t codeSet = 0;
+	size_t index = 0;
+
+	CTLGChunkIterator chunks(&buffer[0], buffer.size());
+	CTLGChunk chunk;
+	while (chunks.Next(chunk)) {
+		CHECK(index < 4 && chunk.id == kChunks[index]);
+		index++;
+
+		// Every chunk starts on a word boundary, and odd ones are padded
+		// with a zero
+		size_t offset = chunk.data - &buffer[0];
+		CHECK((offset & 1) == 0);
+		if ((chunk.size & 1) != 0)
+			CHECK(chunk.data[chunk.size] == 0);
+
+		switch (chunk.id) {
+			case 'FVER':
+				CHECK(chunk.size == strlen(kVersion) + 1);
+				CHECK(memcmp(chunk.data, kVersion, chunk.size) == 0);
+				break;
+			case 'LANG':
+				CHECK(chunk.size == strlen(kLanguage) + 1);
+				CHECK(memcmp(chunk.data, kLanguage, chunk.size) == 0);
+				break;
+			case 'CSET':
+				// The code set, then 7 reserved longs
+				CHECK(chunk.size == 32);
+				codeSet = ctlg_read_uint32(chunk.data);
+				for (size_t i = 4; i < chunk.size; i++)
+					CHECK(chunk.data[i] == 0);
+				break;
+			case 'STRS':
+			{
+				const uint8_t* position = chunk.data;
+				const uint8_t* end = chunk.data + chunk.size;
+				uint32_t previousID = 0;
+				while (position < end) {
+					CHECK(end - position >= 8);
+					uint32_t id = ctlg_read_uint32(position);
+					size_t length = ctlg_read_uint32(position + 4);
+					CHECK(position == chunk.data || id > previousID);
+					previousID = id;
+
+					// The length includes the terminating NULL, and the
+					// entry is padded with zeroes to the next DWORD
+					const uint8_t* string = position + 8;
+					size_t padded = (length + 3) & ~(size_t)3;
+					CHECK(length > 0 && string + padded <= end);
+					CHECK(strnlen((const char*)string, length)
+						== length - 1);
+					for (size_t i = length - 1; i < padded; i++)
+						CHECK(string[i] == 0);
+					position = string + padded;
+				}
+				CHECK(position == end);
+				break;
+			}
+		}
+	}
+	CHECK(chunks.IsValid());
+	CHECK(index == 4);
+	return codeSet;
+}
+
+
+/*!	Writes the strings, reads them back and writes them again. The strings
+	are checked against \a stored, what the STRS chunk should hold for each
+	of them.
+*/
+static void
+check_round_trip(const TestString* strings, size_t count,
+	const char* const* stored, uint32_t expectedCodeSet)
+{
+	CTLGWriter writer(kVersion, kLanguage);
+	uint32_t fingerprint = 0;
+	for (size_t i = 0; i < count; i++) {
+		CHECK(writer.AddString(strings[i].id, strings[i].string,
+			strlen(strings[i].string)));
+		fingerprint += strings[i].id;
+	}
+	std::vector<uint8_t> buffer;
+	CHECK(writer.Flatten(buffer));
+	CHECK(writer.Fingerprint() == fingerprint);
+	CHECK(check_layout(buffer) == expectedCodeSet);
+
+	IDStringTable table;
+	CHECK(read_catalog(buffer, table));
+	CHECK(table.CountItems() == count);
+	for (size_t i = 0; i < count; i++) {
+		const char* string = table.Lookup(strings[i].id);
+		CHECK(string != NULL && strcmp(string, strings[i].string) == 0);
+
+		// Strings are written in ascending ID order, which is how the
+		// test strings are sorted
+		const char* storedString = (const char*)&buffer[0] + 12
+			+ 8 + ((strlen(kVersion) + 2) & ~(size_t)1)
+			+ 8 + ((strlen(kLanguage) + 2) & ~(size_t)1)
+			+ 8 + 32 + 8;
+		for (size_t j = 0; j < i; j++)
+			storedString += 8 + ((strlen(stored[j]) + 1 + 3) & ~(size_t)3);
+		CHECK(ctlg_read_uint32((const uint8_t*)storedString)
+			== strings[i].id);
+		CHECK(strcmp(storedString + 8, stored[i]) == 0);
+	}
+
+	check_write_back(buffer, fingerprint);
+}
+
+
+static void
+check_duplicates()
+{
+	CTLGWriter writer(kVersion, kLanguage);
+	CHECK(writer.AddString(7, "first", 5));
+	CHECK(writer.AddString(3, "other", 5));
+	CHECK(writer.AddString(7, "second", 6));
+	CHECK(writer.AddString(7, "last", 4));
+	std::vector<uint8_t> buffer;
+	CHECK(writer.Flatten(buffer));
+	check_layout(buffer);
+
+	// Duplicates count once in the fingerprint, as in the table
+	CHECK(writer.Fingerprint() == 10);
+
+	IDStringTable table;
+	CHECK(read_catalog(buffer, table));
+	CHECK(table.CountItems() == 2);
+	CHECK(table.Fingerprint() == 10);
+	const char* string = table.Lookup(7);
+	CHECK(string != NULL && strcmp(string, "last") == 0);
+	string = table.Lookup(3);
+	CHECK(string != NULL && strcmp(string, "other") == 0);
+
+	check_write_back(buffer, 10);
+}
+
+
+/*!	Strings set through the editor interface are added after the ones of
+	the file, as WriteToFile() does, and replace them.
+*/
+static void
+check_overrides()
+{
+	CTLGWriter writer(kVersion, kLanguage);
+	CHECK(writer.AddString(1, "Öffnen", strlen("Öffnen")));
+	CHECK(writer.AddString(2, "Schließen", strlen("Schließen")));
+	std::vector<uint8_t> buffer;
+	CHECK(writer.Flatten(buffer));
+
+	IDStringTable table;
+	CHECK(read_catalog(buffer, table));
+
+	CTLGWriter editor(kVersion, kLanguage);
+	CHECK(add_table_strings(editor, table));
+	CHECK(editor.AddString(2, "Zumachen", 8));
+	CHECK(editor.AddString(5, "Закрыть", strlen("Закрыть")));
+	std::vector<uint8_t> edited;
+	CHECK(editor.Flatten(edited));
+	CHECK(editor.Fingerprint() == 8);
+
+	// The new string doesn't fit in ISO-8859-1, so the catalog is UTF-8 now
+	CHECK(check_layout(edited) == kCTLGCodeSetUTF8);
+
+	IDStringTable editedTable;
+	CHECK(read_catalog(edited, editedTable));
+	CHECK(editedTable.CountItems() == 3);
+	CHECK(editedTable.Fingerprint() == 8);
+	const char* string = editedTable.Lookup(1);
+	CHECK(string != NULL && strcmp(string, "Öffnen") == 0);
+	string = editedTable.Lookup(2);
+	CHECK(string != NULL && strcmp(string, "Zumachen") == 0);
+	string = editedTable.Lookup(5);
+	CHECK(string != NULL && strcmp(string, "Закрыть") == 0);
+
+	check_write_back(edited, 8);
+}
+
+
+/*!	The "X\0" menu shortcut prefix is not part of the string that is looked
+	up. It is dropped while reading, so writing the catalog back loses it.
+*/
+static void
+check_shortcuts()
+{
+	const char kShortcut[] = "O\0Open";
+	CTLGWriter writer(kVersion, kLanguage);
+	writer.SetCodeSet(kCTLGCodeSetLatin1);
+	CHECK(writer.AddString(1, kShortcut, sizeof(kShortcut) - 1));
+	CHECK(writer.AddString(2, "Quit", 4));
+	std::vector<uint8_t> buffer;
+	CHECK(writer.Flatten(buffer));
+
+	IDStringTable table;
+	CHECK(read_catalog(buffer, table));
+	const char* string = table.Lookup(1);
+	CHECK(string != NULL && strcmp(string, "Open") == 0);
+
+	CTLGWriter editor(kVersion, kLanguage);
+	CHECK(add_table_strings(editor, table));
+	std::vector<uint8_t> written;
+	CHECK(editor.Flatten(written));
+	check_layout(written);
+
+	std::string file(written.begin(), written.end());
+	CHECK(file.find(std::string(kShortcut, sizeof(kShortcut) - 1))
+		== std::string::npos);
+	CHECK(file.find(std::string("Open\0", 5)) != std::string::npos);
+}
+
+
+int
+main(int argc, char** argv)
+{
+	// Strings that fit in ISO-8859-1 are stored in it
+	const TestString kLatin1Strings[] = {
+		{ 0, "Datei" },
+		{ 1, "Öffnen" },
+		{ 2, "Schließen" },
+		{ 3, "" },
+		{ 10, "Größe: 10 µm, 5 °C" },
+		{ 1000, "abc" }
+	};
+	const char* const kLatin1Stored[] = {
+		"Datei", "\xd6" "ffnen", "Schlie\xdf" "en", "",
+		"Gr\xf6\xdf" "e: 10 \xb5m, 5 \xb0" "C", "abc"
+	};
+	check_round_trip(kLatin1Strings,
+		sizeof(kLatin1Strings) / sizeof(kLatin1Strings[0]), kLatin1Stored,
+		kCTLGCodeSetLatin1);
+
+	// Otherwise, they are all stored as UTF-8
+	const TestString kUTF8Strings[] = {
+		{ 1, "Öffnen…" },
+		{ 2, "Закрыть окно" },
+		{ 3, "ウィンドウを閉じる 😀" },
+		{ 4, "Plain ASCII" },
+		{ 70000, "Fermer" }
+	};
+	const char* const kUTF8Stored[] = {
+		"Öffnen…", "Закрыть окно", "ウィンドウを閉じる 😀", "Plain ASCII",
+		"Fermer"
+	};
+	check_round_trip(kUTF8Strings,
+		sizeof(kUTF8Strings) / sizeof(kUTF8Strings[0]), kUTF8Stored,
+		kCTLGCodeSetUTF8);
+
+	check_duplicates();
+	check_overrides();
+	check_shortcuts();
+
+	return test_result(argv[0]);
+}
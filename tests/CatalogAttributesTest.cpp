@@ -0,0 +1,111 @@
+/*
+ * Copyright 2026, Adrien Destugues, pulkomandy@pulkomandy.tk.
+ * Distributed under the terms of the MIT License.
+ */
+
+/*	Checks which catalog files are skipped on their attributes, which are
+ *	user extended attributes here.
+ */
+
+
+#include <errno.h>
+#include <fcntl.h>
+
+#include <sys/xattr.h>
+
+#include <string>
+
+#include "CatalogAttributes.h"
+#include "Test.h"
+
+
+using BPrivate::catalog_attributes_match;
+using BPrivate::write_catalog_attributes;
+
+
+static const char* kName = "StyledEdit";
+static const char* kMimeSignature = "application/x-vnd.Haiku-StyledEdit";
+
+
+static int
+create_file(const std::string& path)
+{
+	int fd = open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+	CHECK(fd >= 0);
+	return fd;
+}
+
+
+static void
+check_signature(int fd)
+{
+	CHECK(catalog_attributes_match(fd, kName, kMimeSignature, 0));
+
+	// MIME types are not case sensitive, names are
+	CHECK(catalog_attributes_match(fd, kName,
+		"application/x-vnd.haiku-styledEdit", 0));
+	CHECK(!catalog_attributes_match(fd, "styledEdit",
+		"application/x-vnd.Haiku-Other", 0));
+
+	CHECK(!catalog_attributes_match(fd, "Other", NULL, 0));
+	CHECK(!catalog_attributes_match(fd, "Other",
+		"application/x-vnd.Haiku-Other", 0));
+}
+
+
+int
+main(int argc, char** argv)
+{
+	TemporaryDirectory directory;
+
+	// Without any attributes, everything matches
+	int plain = create_file(directory.Path("plain.catalog"));
+	CHECK(catalog_attributes_match(plain, kName, kMimeSignature, 0));
+	CHECK(catalog_attributes_match(plain, "Other", NULL, 1234));
+	close(plain);
+
+	// Some file systems, like older tmpfs, can't store them
+	int fd = create_file(directory.Path("mime.catalog"));
+	if (!write_catalog_attributes(fd, kMimeSignature, "Deutsch", 1234)) {
+		CHECK(errno == ENOTSUP);
+		printf("Extended attributes are not supported here, skipping\n");
+		close(fd);
+		return test_result(argv[0]);
+	}
+
+	// catcompile writes the signature from the catkeys file
+	check_signature(fd);
+
+	// The fingerprint is only checked when one is asked for
+	CHECK(catalog_attributes_match(fd, kName, kMimeSignature, 1234));
+	CHECK(!catalog_attributes_match(fd, kName, kMimeSignature, 1235));
+	close(fd);
+
+	// Catalogs may also be named after the executable
+	fd = create_file(directory.Path("name.catalog"));
+	CHECK(write_catalog_attributes(fd, kName, "Deutsch", 1234));
+	CHECK(catalog_attributes_match(fd, kName, NULL, 0));
+	CHECK(catalog_attributes_match(fd, kName, kMimeSignature, 1234));
+	CHECK(!catalog_attributes_match(fd, "Other", kMimeSignature, 0));
+	close(fd);
+
+	// The language is not checked, the folder tells it
+	fd = create_file(directory.Path("language.catalog"));
+	CHECK(write_catalog_attributes(fd, kMimeSignature, "German", 1234));
+	check_signature(fd);
+
+	// Files of another type are for another add-on
+	CHECK(fsetxattr(fd, "user.BEOS:TYPE", "text/plain", 11, 0) == 0);
+	CHECK(!catalog_attributes_match(fd, kName, kMimeSignature, 0));
+	close(fd);
+
+	// A single missing attribute matches too
+	fd = create_file(directory.Path("fingerprint.catalog"));
+	CHECK(fsetxattr(fd, "user.BEOS:LOCALE_SIGNATURE", kMimeSignature,
+		strlen(kMimeSignature) + 1, 0) == 0);
+	CHECK(catalog_attributes_match(fd, kName, kMimeSignature, 1235));
+	CHECK(!catalog_attributes_match(fd, "Other", NULL, 1235));
+	close(fd);
+
+	return test_result(argv[0]);
+}
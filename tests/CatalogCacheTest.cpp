@@ -0,0 +1,258 @@
+/*
+ * Copyright 2026, Adrien Destugues, pulkomandy@pulkomandy.tk.
+ * Distributed under the terms of the MIT License.
+ */
+
+/*	Checks that cached catalogs, in files or in shared memory, are only used
+ *	as long as the catalog file they were made from didn't change.
+ */
+
+
+#include <fcntl.h>
+#include <time.h>
+
+#include <sys/mman.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "CatalogCache.h"
+#include "CatalogLoader.h"
+#include "CTLGWriter.h"
+#include "MappedFile.h"
+#include "SharedImage.h"
+#include "StringTable.h"
+#include "Test.h"
+
+
+using BPrivate::CatalogCache;
+using BPrivate::CTLGWriter;
+using BPrivate::IDStringTable;
+using BPrivate::MappedFile;
+using BPrivate::read_mapped_catalog;
+using BPrivate::SharedImage;
+
+
+static bool
+write_catalog(const std::string& path, const char* firstString)
+{
+	CTLGWriter writer("x-vnd.Test-CatalogCache", "deutsch");
+	std::vector<uint8_t> buffer;
+	if (!writer.AddString(1, firstString, strlen(firstString))
+		|| !writer.AddString(2, "Öffnen…", strlen("Öffnen…"))
+		|| !writer.Flatten(buffer))
+		return false;
+
+	int fd = open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+	if (fd < 0)
+		return false;
+	ssize_t written = write(fd, &buffer[0], buffer.size());
+	close(fd);
+	return written == (ssize_t)buffer.size();
+}
+
+
+/*!	Reads the catalog and stores it in the cache, keyed by the file as it was
+	before reading it, like the add-on does.
+*/
+static bool
+store_catalog(CatalogCache& cache, const std::string& path)
+{
+	MappedFile source(path.c_str());
+	if (source.InitCheck() != 0)
+		return false;
+
+	IDStringTable strings;
+	std::string version, language;
+	if (read_mapped_catalog(source.Data(), source.Size(), strings, false,
+			version, language) != 0
+		|| !strings.Finish())
+		return false;
+
+	return cache.Store(source.Stat(), strings, version.c_str(),
+		language.c_str(), strings.Fingerprint());
+}
+
+
+/*!	Returns the string with ID 1 from the cache, or an empty string if the
+	cache can't be used.
+*/
+static std::string
+load_first_string(CatalogCache& cache)
+{
+	IDStringTable strings;
+	std::string version, language;
+	uint32_t fingerprint;
+	std::unique_ptr<MappedFile> image(cache.Load(strings, version, language,
+		fingerprint));
+	if (image.get() == NULL)
+		return "";
+
+	CHECK(version == "x-vnd.Test-CatalogCache");
+	CHECK(language == "deutsch");
+	CHECK(fingerprint == 3);
+	CHECK(strings.CountItems() == 2);
+	CHECK(strings.Lookup(2) != NULL
+		&& strcmp(strings.Lookup(2), "Öffnen…") == 0);
+
+	const char* string = strings.Lookup(1);
+	return string != NULL ? string : "(missing)";
+}
+
+
+/*!	Publishes the catalog in shared memory, like the add-on does when there
+	is no cache directory.
+*/
+static SharedImage*
+publish_catalog(CatalogCache& cache, const std::string& path)
+{
+	MappedFile source(path.c_str());
+	if (source.InitCheck() != 0)
+		return NULL;
+
+	IDStringTable strings;
+	std::string version, language;
+	if (read_mapped_catalog(source.Data(), source.Size(), strings, false,
+			version, language) != 0
+		|| !strings.Finish())
+		return NULL;
+
+	return cache.Publish(source.Stat(), strings, version.c_str(),
+		language.c_str(), strings.Fingerprint());
+}
+
+
+static std::string
+attach_first_string(CatalogCache& cache)
+{
+	IDStringTable strings;
+	std::string version, language;
+	uint32_t fingerprint;
+	std::unique_ptr<SharedImage> image(cache.Attach(strings, version,
+		language, fingerprint));
+	if (image.get() == NULL)
+		return "";
+
+	CHECK(fingerprint == 3);
+	const char* string = strings.Lookup(1);
+	return string != NULL ? string : "(missing)";
+}
+
+
+static void
+set_modification_time(const std::string& path, time_t time)
+{
+	struct timespec times[2];
+	times[0].tv_sec = times[1].tv_sec = time;
+	times[0].tv_nsec = times[1].tv_nsec = 0;
+	CHECK(utimensat(AT_FDCWD, path.c_str(), times, 0) == 0);
+}
+
+
+int
+main(int argc, char** argv)
+{
+	TemporaryDirectory directory;
+	std::string path = directory.Path("test.catalog");
+	std::string cacheDirectory = directory.Path("cache");
+	CatalogCache cache(cacheDirectory.c_str(), path.c_str());
+
+	// Nothing cached yet
+	CHECK(write_catalog(path, "Datei"));
+	CHECK(load_first_string(cache) == "");
+
+	CHECK(store_catalog(cache, path));
+	CHECK(load_first_string(cache) == "Datei");
+
+	// Touching the catalog makes the cache outdated
+	struct stat st;
+	CHECK(stat(path.c_str(), &st) == 0);
+	set_modification_time(path, st.st_mtime + 10);
+	CHECK(load_first_string(cache) == "");
+
+	CHECK(store_catalog(cache, path));
+	CHECK(load_first_string(cache) == "Datei");
+
+	// So does changing its size, even if the time is set back
+	CHECK(stat(path.c_str(), &st) == 0);
+	CHECK(write_catalog(path, "Alle Dateien"));
+	set_modification_time(path, st.st_mtime);
+	CHECK(load_first_string(cache) == "");
+
+	// And replacing it with another file, even of the same size and time
+	CHECK(store_catalog(cache, path));
+	CHECK(load_first_string(cache) == "Alle Dateien");
+	CHECK(stat(path.c_str(), &st) == 0);
+	std::string otherPath = directory.Path("other.catalog");
+	CHECK(write_catalog(otherPath, "Alle Ordner!"));
+	set_modification_time(otherPath, st.st_mtime);
+	CHECK(rename(otherPath.c_str(), path.c_str()) == 0);
+	CHECK(load_first_string(cache) == "");
+
+	// A cache made from a catalog that changed while it was being read is
+	// outdated from the start.
+	MappedFile source(path.c_str());
+	CHECK(source.InitCheck() == 0);
+	CHECK(stat(path.c_str(), &st) == 0);
+	set_modification_time(path, st.st_mtime + 20);
+	IDStringTable strings;
+	std::string version, language;
+	CHECK(read_mapped_catalog(source.Data(), source.Size(), strings, false,
+		version, language) == 0);
+	CHECK(strings.Finish());
+	CHECK(cache.Store(source.Stat(), strings, version.c_str(),
+		language.c_str(), strings.Fingerprint()));
+	CHECK(load_first_string(cache) == "");
+
+	// Shared images are checked the same way
+	CHECK(write_catalog(path, "Datei"));
+	CatalogCache sharedCache(NULL, path.c_str());
+	CHECK(attach_first_string(sharedCache) == "");
+	std::unique_ptr<SharedImage> published(publish_catalog(sharedCache,
+		path));
+	CHECK(published.get() != NULL);
+	CHECK(attach_first_string(sharedCache) == "Datei");
+
+	// Outdated ones are removed, even if the catalog gets its old
+	// modification time back
+	CHECK(stat(path.c_str(), &st) == 0);
+	set_modification_time(path, st.st_mtime + 10);
+	CHECK(attach_first_string(sharedCache) == "");
+	set_modification_time(path, st.st_mtime);
+	CHECK(attach_first_string(sharedCache) == "");
+
+	published.reset(publish_catalog(sharedCache, path));
+	CHECK(published.get() != NULL);
+	CHECK(attach_first_string(sharedCache) == "Datei");
+	published.reset();
+
+	// It outlives the publisher, until it is outdated
+	CHECK(attach_first_string(sharedCache) == "Datei");
+	set_modification_time(path, st.st_mtime + 20);
+	CHECK(attach_first_string(sharedCache) == "");
+
+	// Images are private to their user, and those that are not are ignored
+	const char kData[] = "image";
+	{
+		SharedImage image("/amigacatalog-test", kData, sizeof(kData));
+		CHECK(image.InitCheck() == 0);
+
+		char name[64];
+		snprintf(name, sizeof(name), "/amigacatalog-test-%u",
+			(unsigned)geteuid());
+		int fd = shm_open(name, O_RDONLY, 0);
+		CHECK(fd >= 0);
+		CHECK(fstat(fd, &st) == 0 && (st.st_mode & 0777) == 0600);
+		CHECK(fchmod(fd, 0644) == 0);
+		close(fd);
+
+		SharedImage attached("/amigacatalog-test");
+		CHECK(attached.InitCheck() != 0);
+	}
+	SharedImage::Remove("/amigacatalog-test");
+	SharedImage removed("/amigacatalog-test");
+	CHECK(removed.InitCheck() == ENOENT);
+
+	return test_result(argv[0]);
+}
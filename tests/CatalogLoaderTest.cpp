@@ -0,0 +1,215 @@
+/*
+ * Copyright 2026, Adrien Destugues, pulkomandy@pulkomandy.tk.
+ * Distributed under the terms of the MIT License.
+ */
+
+/*	Checks that strings which are valid UTF-8 already are never converted
+ *	a second time, by the decoder used when the code set is not known, and
+ *	by whole catalogs loaded in any way.
+ */
+
+
+#include <fcntl.h>
+
+#include <random>
+#include <string>
+#include <vector>
+
+#include "CatalogLoader.h"
+#include "CharsetConversion.h"
+#include "CTLGReader.h"
+#include "CTLGWriter.h"
+#include "StringTable.h"
+#include "Test.h"
+
+
+using BPrivate::code_set_decoder;
+using BPrivate::CTLGWriter;
+using BPrivate::IDStringTable;
+using BPrivate::is_valid_utf8;
+using BPrivate::kCTLGCodeSetLatin1;
+using BPrivate::kCTLGCodeSetUTF8;
+using BPrivate::latin1_to_utf8;
+using BPrivate::read_mapped_catalog;
+using BPrivate::read_streamed_catalog;
+
+
+static const uint32_t kUnknownCodeSet = 3000;
+
+
+static std::string
+encode_utf8(uint32_t c)
+{
+	std::string string;
+	if (c < 0x80)
+		string += (char)c;
+	else if (c < 0x800) {
+		string += (char)(0xc0 | (c >> 6));
+		string += (char)(0x80 | (c & 0x3f));
+	} else if (c < 0x10000) {
+		string += (char)(0xe0 | (c >> 12));
+		string += (char)(0x80 | ((c >> 6) & 0x3f));
+		string += (char)(0x80 | (c & 0x3f));
+	} else {
+		string += (char)(0xf0 | (c >> 18));
+		string += (char)(0x80 | ((c >> 12) & 0x3f));
+		string += (char)(0x80 | ((c >> 6) & 0x3f));
+		string += (char)(0x80 | (c & 0x3f));
+	}
+	return string;
+}
+
+
+static std::string
+decode(const IDStringTable::Decoder* decoder, const std::string& string)
+{
+	std::vector<char> target(decoder->MaxDecodedLength(string.size()) + 1);
+	size_t length = decoder->Decode(string.data(), string.size(),
+		&target[0]);
+	CHECK(length <= decoder->MaxDecodedLength(string.size()));
+	return std::string(&target[0], length);
+}
+
+
+static std::string
+latin1(const std::string& string)
+{
+	std::vector<char> target(string.size() * 2 + 1);
+	return std::string(&target[0],
+		latin1_to_utf8(string.data(), string.size(), &target[0]));
+}
+
+
+static void
+check_decoder()
+{
+	const IDStringTable::Decoder* decoder = code_set_decoder(0);
+	CHECK(code_set_decoder(kUnknownCodeSet) == decoder);
+
+	// Every code point, alone and among others
+	for (uint32_t c = 1; c <= 0x10ffff; c++) {
+		if (c >= 0xd800 && c <= 0xdfff)
+			continue;
+
+		std::string string = encode_utf8(c);
+		CHECK(decode(decoder, string) == string);
+
+		string = "Datei " + string + " öffnen";
+		CHECK(decode(decoder, string) == string);
+	}
+
+	// Random strings of several scripts
+	std::mt19937 random(1);
+	std::uniform_int_distribution<uint32_t> codePoint(0x80, 0x10ffff);
+	std::uniform_int_distribution<uint32_t> ascii(0x20, 0x7e);
+	std::uniform_int_distribution<size_t> length(0, 200);
+	for (int i = 0; i < 20000; i++) {
+		std::string string;
+		for (size_t count = length(random); count > 0; count--) {
+			uint32_t c = count % 3 == 0 ? codePoint(random) : ascii(random);
+			if (c >= 0xd800 && c <= 0xdfff)
+				c = 'x';
+			string += encode_utf8(c);
+		}
+		CHECK(is_valid_utf8(string.data(), string.size()));
+		CHECK(decode(decoder, string) == string);
+	}
+
+	// Anything else is ISO-8859-1, even if parts of it would be valid
+	// UTF-8
+	const char* const kLatin1Strings[] = {
+		"Sch\xf6n", "\xc3\xa9t\xe9", "Gr\xfc\xdf" "e", "\xe9", "\xc3",
+		"\xc2\xa0\xa0", "\xef\xbb\xbf\xff"
+	};
+	for (size_t i = 0; i < sizeof(kLatin1Strings) / sizeof(kLatin1Strings[0]);
+			i++) {
+		std::string string = kLatin1Strings[i];
+		CHECK(!is_valid_utf8(string.data(), string.size()));
+		CHECK(decode(decoder, string) == latin1(string));
+	}
+}
+
+
+/*!	Writes a catalog of \a strings stored as they are, with the given code
+	set, and checks that loading it in any way gives \a expected.
+*/
+static void
+check_catalog(uint32_t codeSet, const std::vector<std::string>& strings,
+	const std::vector<std::string>& expected)
+{
+	CTLGWriter writer("x-vnd.Test-CatalogLoader", "français");
+	writer.SetCodeSet(codeSet);
+	for (size_t i = 0; i < strings.size(); i++)
+		CHECK(writer.AddString(i, strings[i].data(), strings[i].size()));
+	std::vector<uint8_t> buffer;
+	CHECK(writer.Flatten(buffer));
+
+	TemporaryDirectory directory;
+	std::string path = directory.Path("test.catalog");
+	int fd = open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+	CHECK(fd >= 0);
+	CHECK(write(fd, &buffer[0], buffer.size()) == (ssize_t)buffer.size());
+	close(fd);
+
+	for (int mode = 0; mode < 3; mode++) {
+		IDStringTable table;
+		std::string version, language;
+		if (mode < 2) {
+			CHECK(read_mapped_catalog(&buffer[0], buffer.size(), table,
+				mode == 1, version, language) == 0);
+		} else {
+			fd = open(path.c_str(), O_RDONLY);
+			CHECK(read_streamed_catalog(fd, table, version, language) == 0);
+			close(fd);
+		}
+		CHECK(table.Finish());
+
+		CHECK(language == "français");
+		CHECK(table.CountItems() == expected.size());
+		for (size_t i = 0; i < expected.size(); i++) {
+			const char* string = table.Lookup(i);
+			CHECK(string != NULL && string == expected[i]);
+		}
+	}
+}
+
+
+int
+main(int argc, char** argv)
+{
+	check_decoder();
+
+	std::vector<std::string> utf8Strings;
+	utf8Strings.push_back("Öffnen…");
+	utf8Strings.push_back("Fermer la fenêtre");
+	utf8Strings.push_back("Zamknij okno, zakończ");
+	utf8Strings.push_back("Закрыть окно");
+	utf8Strings.push_back("ウィンドウを閉じる 😀");
+	utf8Strings.push_back("Plain ASCII");
+	utf8Strings.push_back("");
+
+	// UTF-8 catalogs, and those that don't tell, keep the strings as they
+	// are.
+	check_catalog(kCTLGCodeSetUTF8, utf8Strings, utf8Strings);
+	check_catalog(kUnknownCodeSet, utf8Strings, utf8Strings);
+
+	// Latin-1 ones are converted, once
+	std::vector<std::string> latin1Strings;
+	std::vector<std::string> convertedStrings;
+	for (size_t i = 0; i < utf8Strings.size(); i++) {
+		latin1Strings.push_back(utf8Strings[i]);
+		convertedStrings.push_back(latin1(utf8Strings[i]));
+	}
+	latin1Strings.push_back("Sch\xf6n");
+	convertedStrings.push_back("Schön");
+	check_catalog(kCTLGCodeSetLatin1, latin1Strings, convertedStrings);
+
+	// Without a code set, a mix of both gives UTF-8 in the end
+	std::vector<std::string> mixedStrings = utf8Strings;
+	mixedStrings.push_back("Sch\xf6n");
+	std::vector<std::string> expectedStrings = utf8Strings;
+	expectedStrings.push_back("Schön");
+	check_catalog(kUnknownCodeSet, mixedStrings, expectedStrings);
+
+	return test_result(argv[0]);
+}
@@ -0,0 +1,298 @@
+/*
+ * Copyright 2026, Adrien Destugues, pulkomandy@pulkomandy.tk.
+ * Distributed under the terms of the MIT License.
+ */
+
+/*	Checks latin1_to_utf8() against a plain conversion of one byte at a time,
+ *	and against iconv, for every byte value at every position of strings
+ *	longer than the blocks the kernels work on. is_valid_utf8() is checked
+ *	against a plain decoder for every sequence of up to three bytes, and
+ *	every code point. The kernels are chosen at compile time, so this is
+ *	built once for each of them.
+ */
+
+
+#include <iconv.h>
+#include <stdint.h>
+
+#include <random>
+#include <string>
+#include <vector>
+
+#include "CharsetConversion.h"
+#include "Test.h"
+
+
+using BPrivate::is_valid_utf8;
+using BPrivate::latin1_to_utf8;
+using BPrivate::utf8_to_latin1;
+
+
+static const size_t kMaxLength = 3 * 32 + 2;
+	// covers all the block sizes with some bytes left, and crosses them
+	// at every position
+static const size_t kMaxOffset = 32;
+static const uint8_t kCanary = 0xa5;
+
+
+/*!	Code points 0 to 255 are the same in ISO-8859-1 and Unicode, so each byte
+	gives one or two UTF-8 bytes.
+*/
+static std::string
+reference_latin1_to_utf8(const std::string& source)
+{
+	std::string target;
+	for (size_t i = 0; i < source.size(); i++) {
+		uint8_t c = source[i];
+		if (c < 0x80)
+			target += (char)c;
+		else {
+			target += (char)(0xc0 | (c >> 6));
+			target += (char)(0x80 | (c & 0x3f));
+		}
+	}
+	return target;
+}
+
+
+static std::string
+iconv_latin1_to_utf8(iconv_t converter, const std::string& source)
+{
+	std::vector<char> input(source.begin(), source.end());
+	std::vector<char> output(source.size() * 2 + 1);
+	char* in = input.empty() ? NULL : &input[0];
+	char* out = &output[0];
+	size_t inLeft = input.size();
+	size_t outLeft = output.size();
+	iconv(converter, NULL, NULL, NULL, NULL);
+	if (iconv(converter, &in, &inLeft, &out, &outLeft) == (size_t)-1)
+		return "(iconv failed)";
+	return std::string(&output[0], out - &output[0]);
+}
+
+
+/*!	Converts \a source from \a offset bytes into a buffer, so unaligned loads
+	are exercised, and checks that nothing is written past the room the
+	function may use.
+*/
+static std::string
+convert(const std::string& source, size_t offset)
+{
+	std::vector<char> input(offset + source.size() + 1);
+	memcpy(&input[offset], source.data(), source.size());
+
+	size_t room = source.size() * 2;
+	std::vector<uint8_t> output(offset + room + 64, kCanary);
+	size_t length = latin1_to_utf8(&input[offset], source.size(),
+		(char*)&output[offset]);
+
+	CHECK(length <= room);
+	for (size_t i = 0; i < offset; i++)
+		CHECK(output[i] == kCanary);
+	for (size_t i = offset + room; i < output.size(); i++)
+		CHECK(output[i] == kCanary);
+
+	return std::string((const char*)&output[offset], length);
+}
+
+
+static void
+check(const std::string& source, size_t offset)
+{
+	std::string expected = reference_latin1_to_utf8(source);
+	if (convert(source, offset) != expected) {
+		fprintf(stderr, "conversion of %zu bytes at offset %zu differs\n",
+			source.size(), offset);
+		CHECK(false);
+		return;
+	}
+
+	// And back, which the writer relies on
+	size_t length;
+	std::vector<char> back(source.size() + 1);
+	CHECK(utf8_to_latin1(expected.data(), expected.size(), &back[0], length));
+	CHECK(length == source.size()
+		&& memcmp(&back[0], source.data(), length) == 0);
+}
+
+
+/*!	Decodes one code point after the other, as the Unicode standard
+	describes it: the shortest form only, no surrogates, nothing past
+	U+10FFFF.
+*/
+static bool
+reference_is_valid_utf8(const std::string& source)
+{
+	for (size_t i = 0; i < source.size();) {
+		uint8_t c = source[i];
+		size_t count;
+		uint32_t codePoint;
+		if (c < 0x80) {
+			i++;
+			continue;
+		} else if ((c & 0xe0) == 0xc0) {
+			count = 1;
+			codePoint = c & 0x1f;
+		} else if ((c & 0xf0) == 0xe0) {
+			count = 2;
+			codePoint = c & 0x0f;
+		} else if ((c & 0xf8) == 0xf0) {
+			count = 3;
+			codePoint = c & 0x07;
+		} else
+			return false;
+
+		if (i + count >= source.size())
+			return false;
+		for (size_t j = 1; j <= count; j++) {
+			uint8_t next = source[i + j];
+			if ((next & 0xc0) != 0x80)
+				return false;
+			codePoint = (codePoint << 6) | (next & 0x3f);
+		}
+
+		static const uint32_t kMinimum[] = { 0, 0x80, 0x800, 0x10000 };
+		if (codePoint < kMinimum[count] || codePoint > 0x10ffff
+			|| (codePoint >= 0xd800 && codePoint <= 0xdfff))
+			return false;
+		i += count + 1;
+	}
+	return true;
+}
+
+
+static std::string
+encode_utf8(uint32_t c)
+{
+	std::string string;
+	if (c < 0x80)
+		string += (char)c;
+	else if (c < 0x800) {
+		string += (char)(0xc0 | (c >> 6));
+		string += (char)(0x80 | (c & 0x3f));
+	} else if (c < 0x10000) {
+		string += (char)(0xe0 | (c >> 12));
+		string += (char)(0x80 | ((c >> 6) & 0x3f));
+		string += (char)(0x80 | (c & 0x3f));
+	} else {
+		string += (char)(0xf0 | (c >> 18));
+		string += (char)(0x80 | ((c >> 12) & 0x3f));
+		string += (char)(0x80 | ((c >> 6) & 0x3f));
+		string += (char)(0x80 | (c & 0x3f));
+	}
+	return string;
+}
+
+
+/*!	Validates \a sequence after \a prefix bytes of ASCII, so it ends up at
+	any place in the blocks.
+*/
+static void
+check_validation(const std::string& sequence, size_t prefix)
+{
+	std::string source = std::string(prefix, 'a') + sequence;
+	bool expected = reference_is_valid_utf8(sequence);
+	if (is_valid_utf8(source.data(), source.size()) != expected) {
+		fprintf(stderr, "validation of %zu bytes after %zu differs\n",
+			sequence.size(), prefix);
+		CHECK(false);
+	}
+}
+
+
+static void
+check_utf8_validation()
+{
+	// Every sequence of up to three bytes, including the truncated,
+	// overlong and surrogate ones
+	for (uint32_t bytes = 0; bytes < 0x1000000; bytes++) {
+		char sequence[3] = { (char)(bytes >> 16), (char)(bytes >> 8),
+			(char)bytes };
+		check_validation(std::string(sequence, 3), bytes % 40);
+		if ((bytes & 0xffff) == 0)
+			check_validation(std::string(sequence, 1), (bytes >> 16) & 31);
+		if ((bytes & 0xff) == 0)
+			check_validation(std::string(sequence, 2), (bytes >> 8) & 31);
+	}
+
+	// Every code point, valid on its own except for surrogates, but never
+	// with a byte missing
+	for (uint32_t c = 0; c <= 0x10ffff; c++) {
+		std::string sequence = encode_utf8(c);
+		bool surrogate = c >= 0xd800 && c <= 0xdfff;
+		CHECK(is_valid_utf8(sequence.data(), sequence.size()) != surrogate);
+		check_validation(sequence + "b", c % 40);
+		if (sequence.size() > 1)
+			check_validation(sequence.substr(0, sequence.size() - 1), c % 40);
+	}
+
+	// Every four byte lead with sequences past U+10FFFF
+	for (int lead = 0xf0; lead < 0x100; lead++) {
+		for (int second = 0; second < 0x100; second++) {
+			char sequence[4] = { (char)lead, (char)second, (char)0x80,
+				(char)0x80 };
+			check_validation(std::string(sequence, 4), second % 40);
+		}
+	}
+}
+
+
+int
+main(int argc, char** argv)
+{
+	// Every byte value at every position in an ASCII string, at every
+	// alignment
+	for (size_t length = 1; length <= kMaxLength; length++) {
+		for (size_t position = 0; position < length; position++) {
+			for (int c = 0; c < 256; c++) {
+				std::string source(length, 'a');
+				source[position] = (char)c;
+				check(source, position % kMaxOffset);
+			}
+		}
+	}
+
+	// Every pair of bytes, on each side of a block boundary
+	for (int first = 0; first < 256; first++) {
+		for (int second = 0; second < 256; second++) {
+			std::string source(64, 'x');
+			source[31] = (char)first;
+			source[32] = (char)second;
+			check(source, first % kMaxOffset);
+			check(source.substr(31, 2), second % kMaxOffset);
+		}
+	}
+
+	// Random strings with more or less non-ASCII bytes, also against iconv
+	iconv_t converter = iconv_open("UTF-8", "ISO-8859-1");
+	CHECK(converter != (iconv_t)-1);
+
+	std::mt19937 random(1);
+	std::uniform_int_distribution<int> percent(0, 99);
+	std::uniform_int_distribution<int> byte(1, 255);
+	std::uniform_int_distribution<int> ascii(1, 127);
+	std::uniform_int_distribution<size_t> length(0, 4 * kMaxLength);
+	for (int i = 0; i < 100000; i++) {
+		int nonASCIIPercent = i % 101;
+		std::string source(length(random), '\0');
+		for (size_t j = 0; j < source.size(); j++) {
+			source[j] = (char)(percent(random) < nonASCIIPercent
+				? byte(random) : ascii(random));
+		}
+
+		check(source, i % kMaxOffset);
+		if (converter != (iconv_t)-1) {
+			CHECK(iconv_latin1_to_utf8(converter, source)
+				== reference_latin1_to_utf8(source));
+		}
+	}
+	if (converter != (iconv_t)-1)
+		iconv_close(converter);
+
+	// Nothing to convert
+	CHECK(convert("", 0).empty());
+
+	check_utf8_validation();
+
+	return test_result(argv[0]);
+}
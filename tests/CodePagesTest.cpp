@@ -0,0 +1,146 @@
+/*
+ * Copyright 2026, Adrien Destugues, pulkomandy@pulkomandy.tk.
+ * Distributed under the terms of the MIT License.
+ */
+
+/*	Checks the table of every code page against iconv, for each of the 256
+ *	byte values alone and for all of them in a single string.
+ */
+
+
+#include <errno.h>
+#include <iconv.h>
+#include <stdint.h>
+
+#include <string>
+#include <vector>
+
+#include "CodePages.h"
+#include "Test.h"
+
+
+using BPrivate::code_page_decoder;
+using BPrivate::IDStringTable;
+
+
+struct CodePage {
+	uint32_t	codeSet;
+		// IANA MIBenum, as in the CSET chunk
+	const char*	iconvName;
+};
+
+
+static const char* kReplacement = "\xef\xbf\xbd";
+	// U+FFFD, for bytes a code page leaves undefined
+
+
+static std::string
+decode(const IDStringTable::Decoder* decoder, const std::string& string)
+{
+	std::vector<char> target(decoder->MaxDecodedLength(string.size()) + 1);
+	size_t length = decoder->Decode(string.data(), string.size(),
+		&target[0]);
+	CHECK(length <= decoder->MaxDecodedLength(string.size()));
+	return std::string(&target[0], length);
+}
+
+
+/*!	Returns the UTF-8 iconv gives for a single byte, or U+FFFD if the byte
+	is not part of the code page.
+*/
+static std::string
+iconv_decode(iconv_t converter, uint8_t byte)
+{
+	char source = byte;
+	char target[8];
+	char* in = &source;
+	char* out = target;
+	size_t inLeft = 1;
+	size_t outLeft = sizeof(target);
+
+	iconv(converter, NULL, NULL, NULL, NULL);
+	if (iconv(converter, &in, &inLeft, &out, &outLeft) == (size_t)-1) {
+		CHECK(errno == EILSEQ);
+		return kReplacement;
+	}
+	return std::string(target, out - target);
+}
+
+
+static void
+check_code_page(const CodePage& codePage)
+{
+	const IDStringTable::Decoder* decoder
+		= code_page_decoder(codePage.codeSet);
+	CHECK(decoder != NULL);
+	if (decoder == NULL)
+		return;
+
+	iconv_t converter = iconv_open("UTF-8", codePage.iconvName);
+	CHECK(converter != (iconv_t)-1);
+	if (converter == (iconv_t)-1)
+		return;
+
+	std::string all;
+	std::string expected;
+	int mismatches = 0;
+	for (int byte = 0; byte < 256; byte++) {
+		std::string reference = iconv_decode(converter, byte);
+		std::string decoded = decode(decoder, std::string(1, (char)byte));
+		if (decoded != reference) {
+			fprintf(stderr, "%s: byte 0x%02x gives", codePage.iconvName,
+				byte);
+			for (size_t i = 0; i < decoded.size(); i++)
+				fprintf(stderr, " %02x", (uint8_t)decoded[i]);
+			fprintf(stderr, " instead of");
+			for (size_t i = 0; i < reference.size(); i++)
+				fprintf(stderr, " %02x", (uint8_t)reference[i]);
+			fprintf(stderr, "\n");
+			mismatches++;
+		}
+
+		all += (char)byte;
+		expected += reference;
+	}
+	CHECK(mismatches == 0);
+
+	// Characters of two bytes are written with three, the next one must
+	// overwrite the extra byte
+	CHECK(decode(decoder, all) == expected);
+
+	iconv_close(converter);
+}
+
+
+int
+main(int argc, char** argv)
+{
+	const CodePage kCodePages[] = {
+		{ 5, "ISO-8859-2" },
+		{ 6, "ISO-8859-3" },
+		{ 7, "ISO-8859-4" },
+		{ 8, "ISO-8859-5" },
+		{ 10, "ISO-8859-7" },
+		{ 12, "ISO-8859-9" },
+		{ 13, "ISO-8859-10" },
+		{ 109, "ISO-8859-13" },
+		{ 110, "ISO-8859-14" },
+		{ 111, "ISO-8859-15" },
+		{ 112, "ISO-8859-16" },
+		{ 2084, "KOI8-R" },
+		{ 2250, "CP1250" },
+		{ 2251, "CP1251" },
+		{ 2252, "CP1252" },
+		{ 2253, "CP1253" },
+		{ 2257, "CP1257" }
+	};
+	for (size_t i = 0; i < sizeof(kCodePages) / sizeof(kCodePages[0]); i++)
+		check_code_page(kCodePages[i]);
+
+	// ISO-8859-1 and UTF-8 have decoders of their own
+	CHECK(code_page_decoder(4) == NULL);
+	CHECK(code_page_decoder(106) == NULL);
+	CHECK(code_page_decoder(3000) == NULL);
+
+	return test_result(argv[0]);
+}
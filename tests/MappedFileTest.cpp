@@ -0,0 +1,129 @@
+/*
+ * Copyright 2026, Adrien Destugues, pulkomandy@pulkomandy.tk.
+ * Distributed under the terms of the MIT License.
+ */
+
+/*	Checks that files are mapped or read as asked, and that lazy tables
+ *	using a read copy keep their strings when the file is truncated or
+ *	written to.
+ */
+
+
+#include <errno.h>
+#include <fcntl.h>
+
+#include <string>
+#include <vector>
+
+#include "CatalogLoader.h"
+#include "CTLGWriter.h"
+#include "MappedFile.h"
+#include "StringTable.h"
+#include "Test.h"
+
+
+using BPrivate::CTLGWriter;
+using BPrivate::IDStringTable;
+using BPrivate::MappedFile;
+using BPrivate::read_mapped_catalog;
+
+
+static std::vector<uint8_t>
+flatten_catalog(const char* firstString, const char* secondString)
+{
+	CTLGWriter writer("x-vnd.Test-MappedFile", "deutsch");
+	std::vector<uint8_t> buffer;
+	CHECK(writer.AddString(1, firstString, strlen(firstString)));
+	CHECK(writer.AddString(2, secondString, strlen(secondString)));
+	CHECK(writer.Flatten(buffer));
+	return buffer;
+}
+
+
+/*!	Writes the file in place, as an editor not renaming a new file over it
+	would.
+*/
+static bool
+write_file(const std::string& path, const std::vector<uint8_t>& buffer)
+{
+	int fd = open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+	if (fd < 0)
+		return false;
+	ssize_t written = buffer.empty() ? 0
+		: write(fd, &buffer[0], buffer.size());
+	close(fd);
+	return written == (ssize_t)buffer.size();
+}
+
+
+static void
+check_modes(const TemporaryDirectory& directory)
+{
+	std::string path = directory.Path("modes.catalog");
+	std::vector<uint8_t> buffer = flatten_catalog("Datei", "Öffnen");
+	CHECK(write_file(path, buffer));
+
+	const MappedFile::Mode kModes[] = {
+		MappedFile::kMapOrRead, MappedFile::kMapOnly, MappedFile::kRead
+	};
+	for (size_t i = 0; i < sizeof(kModes) / sizeof(kModes[0]); i++) {
+		MappedFile file(path.c_str(), kModes[i]);
+		CHECK(file.InitCheck() == 0);
+		CHECK(file.Size() == buffer.size());
+		CHECK(file.Stat().st_size == (off_t)buffer.size());
+		CHECK(file.Data() != NULL
+			&& memcmp(file.Data(), &buffer[0], buffer.size()) == 0);
+	}
+
+	MappedFile missing(directory.Path("missing.catalog").c_str(),
+		MappedFile::kRead);
+	CHECK(missing.InitCheck() == ENOENT);
+
+	std::string emptyPath = directory.Path("empty.catalog");
+	CHECK(write_file(emptyPath, std::vector<uint8_t>()));
+	MappedFile empty(emptyPath.c_str(), MappedFile::kRead);
+	CHECK(empty.InitCheck() == 0 && empty.Size() == 0);
+}
+
+
+/*!	Strings of a lazy table are only decoded when looked up, which happens
+	after the file was changed here. A mapping would fault once the file is
+	truncated, and show the new contents once it is written again.
+*/
+static void
+check_lazy_copy(const TemporaryDirectory& directory)
+{
+	std::string path = directory.Path("lazy.catalog");
+	CHECK(write_file(path, flatten_catalog("Datei", "Öffnen")));
+
+	MappedFile source(path.c_str(), MappedFile::kRead);
+	CHECK(source.InitCheck() == 0);
+
+	IDStringTable strings;
+	std::string version, language;
+	CHECK(read_mapped_catalog(source.Data(), source.Size(), strings, true,
+		version, language) == 0);
+	CHECK(strings.Finish());
+	CHECK(strings.CountDecodedItems() == 0);
+
+	CHECK(truncate(path.c_str(), 0) == 0);
+	const char* string = strings.Lookup(1);
+	CHECK(string != NULL && strcmp(string, "Datei") == 0);
+
+	CHECK(write_file(path, flatten_catalog("Fichier", "Ouvrir")));
+	string = strings.Lookup(2);
+	CHECK(string != NULL && strcmp(string, "Öffnen") == 0);
+	CHECK(strings.CountDecodedItems() == 2);
+}
+
+
+int
+main(int argc, char** argv)
+{
+	TemporaryDirectory directory;
+
+	check_modes(directory);
+	check_lazy_copy(directory);
+
+	return test_result(argv[0]);
+}
@@ -0,0 +1,158 @@
+/*
+ * Copyright 2026, Adrien Destugues, pulkomandy@pulkomandy.tk.
+ * Distributed under the terms of the MIT License.
+ */
+
+/*	Checks lookups in tables of sparse IDs, which use a binary search when
+ *	they are small and a minimal perfect hash otherwise, for IDs that are in
+ *	the table and IDs that are not, before and after going through an image.
+ */
+
+
+#include <stdint.h>
+
+#include <algorithm>
+#include <random>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "StringTable.h"
+#include "Test.h"
+
+
+using BPrivate::IDStringTable;
+
+
+static const uint32_t kMinHashedEntries = 64;
+	// as in StringTable.cpp
+static const size_t kImageBucketCount = 4;
+	// index of the bucket count in the header of an image, after the magic,
+	// the entry count, the first ID and the direct count
+
+
+static std::string
+string_for(uint32_t id)
+{
+	return "string " + std::to_string(id);
+}
+
+
+/*!	Returns \a count random IDs, sorted, spread over the whole range so that
+	the table is too sparse for a direct array.
+*/
+static std::vector<uint32_t>
+random_ids(std::mt19937& random, size_t count)
+{
+	std::set<uint32_t> ids;
+	while (ids.size() < count)
+		ids.insert(random());
+	return std::vector<uint32_t>(ids.begin(), ids.end());
+}
+
+
+/*!	Returns IDs that are not in \a ids: the neighbours of those that are,
+	and random ones.
+*/
+static std::vector<uint32_t>
+absent_ids(std::mt19937& random, const std::vector<uint32_t>& ids)
+{
+	std::vector<uint32_t> candidates;
+	candidates.push_back(0);
+	candidates.push_back(UINT32_MAX);
+	for (size_t i = 0; i < ids.size() && i < 1000; i++) {
+		candidates.push_back(ids[i] - 1);
+		candidates.push_back(ids[i] + 1);
+		candidates.push_back(random());
+	}
+
+	std::vector<uint32_t> absent;
+	for (size_t i = 0; i < candidates.size(); i++) {
+		if (!std::binary_search(ids.begin(), ids.end(), candidates[i]))
+			absent.push_back(candidates[i]);
+	}
+	return absent;
+}
+
+
+static void
+check_lookups(const IDStringTable& table, const std::vector<uint32_t>& ids,
+	const std::vector<uint32_t>& absent)
+{
+	CHECK(table.CountItems() == ids.size());
+
+	uint32_t fingerprint = 0;
+	size_t failed = 0;
+	for (size_t i = 0; i < ids.size(); i++) {
+		fingerprint += ids[i];
+		const char* string = table.Lookup(ids[i]);
+		if (string == NULL || string_for(ids[i]) != string
+			|| !table.Contains(ids[i]) || table.IDAt(i) != ids[i])
+			failed++;
+	}
+	CHECK(failed == 0);
+	CHECK(table.Fingerprint() == fingerprint);
+
+	failed = 0;
+	for (size_t i = 0; i < absent.size(); i++) {
+		if (table.Lookup(absent[i]) != NULL || table.Contains(absent[i]))
+			failed++;
+	}
+	CHECK(failed == 0);
+}
+
+
+static void
+check_table(std::mt19937& random, const std::vector<uint32_t>& ids)
+{
+	// Added in random order, the table sorts them
+	std::vector<uint32_t> order(ids);
+	std::shuffle(order.begin(), order.end(), random);
+
+	IDStringTable table;
+	for (size_t i = 0; i < order.size(); i++) {
+		std::string string = string_for(order[i]);
+		CHECK(table.Add(order[i], string.c_str(), string.size()));
+	}
+	CHECK(table.Finish());
+
+	std::vector<uint32_t> absent = absent_ids(random, ids);
+	check_lookups(table, ids, absent);
+
+	// Images are used in place, so they must be aligned
+	size_t size = table.ImageSize();
+	std::vector<uint32_t> image((size + 3) / 4);
+	table.WriteImage(&image[0]);
+
+	// The perfect hash is only built for tables large enough, and saved
+	// with them
+	CHECK((image[kImageBucketCount] != 0) == (ids.size() >= kMinHashedEntries));
+
+	IDStringTable loaded;
+	CHECK(!loaded.SetImage(&image[0], size - 1));
+	CHECK(loaded.SetImage(&image[0], size));
+	check_lookups(loaded, ids, absent);
+}
+
+
+int
+main(int argc, char** argv)
+{
+	std::mt19937 random(20260522);
+
+	const size_t kSizes[] = {
+		1, 2, 63, 64, 65, 127, 128, 1000, 10000, 100000, 300000
+	};
+	for (size_t i = 0; i < sizeof(kSizes) / sizeof(kSizes[0]); i++)
+		check_table(random, random_ids(random, kSizes[i]));
+
+	// A block of 1000 IDs for each module, each using a few of them
+	std::vector<uint32_t> blocks;
+	for (uint32_t module = 0; module < 500; module++) {
+		for (uint32_t i = 0; i < 10; i++)
+			blocks.push_back(module * 1000 + i * 3);
+	}
+	check_table(random, blocks);
+
+	return test_result(argv[0]);
+}
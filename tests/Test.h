@@ -0,0 +1,106 @@
+/*
+ * Copyright 2026, Adrien Destugues, pulkomandy@pulkomandy.tk.
+ * Distributed under the terms of the MIT License.
+ */
+#ifndef _TEST_H_
+#define _TEST_H_
+
+
+/*	What the tests share. Each test is a plain program that reports failed
+ *	checks on stderr, and exits with a non-zero status if there were any.
+ */
+
+
+#include <dirent.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include <sys/stat.h>
+
+#include <string>
+
+
+static int sFailedChecks = 0;
+
+
+#define CHECK(condition) \
+	do { \
+		if (!(condition)) { \
+			fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, \
+				#condition); \
+			sFailedChecks++; \
+		} \
+	} while (0)
+
+
+static inline int
+test_result(const char* name)
+{
+	// Called with the path of the test, shorten it to its name
+	const char* slash = strrchr(name, '/');
+	if (slash != NULL)
+		name = slash + 1;
+
+	if (sFailedChecks == 0) {
+		printf("%s: passed\n", name);
+		return 0;
+	}
+	printf("%s: %d checks failed\n", name, sFailedChecks);
+	return 1;
+}
+
+
+/*	A folder for the files of a test, removed with everything in it when
+ *	the test is done.
+ */
+class TemporaryDirectory {
+	public:
+		TemporaryDirectory()
+		{
+			char path[] = "/tmp/ctlgtest.XXXXXX";
+			if (mkdtemp(path) == NULL) {
+				perror("mkdtemp");
+				exit(1);
+			}
+			fPath = path;
+		}
+
+		~TemporaryDirectory()
+		{
+			_Remove(fPath);
+		}
+
+		const std::string& Path() const { return fPath; }
+		std::string Path(const char* name) const
+			{ return fPath + "/" + name; }
+
+	private:
+		static void _Remove(const std::string& path)
+		{
+			DIR* dir = opendir(path.c_str());
+			if (dir != NULL) {
+				while (struct dirent* entry = readdir(dir)) {
+					if (strcmp(entry->d_name, ".") == 0
+						|| strcmp(entry->d_name, "..") == 0)
+						continue;
+
+					std::string entryPath = path + "/" + entry->d_name;
+					struct stat st;
+					if (lstat(entryPath.c_str(), &st) == 0
+						&& S_ISDIR(st.st_mode))
+						_Remove(entryPath);
+					else
+						unlink(entryPath.c_str());
+				}
+				closedir(dir);
+			}
+			rmdir(path.c_str());
+		}
+
+		std::string	fPath;
+};
+
+
+#endif /* _TEST_H_ */